@@ -1,4 +1,4 @@
-QT       += core gui network
+QT       += core gui network sql
 
 greaterThan(QT_MAJOR_VERSION, 4): QT += widgets
 
@@ -8,44 +8,10 @@ CONFIG += c++17
 # In order to do so, uncomment the following line.
 #DEFINES += QT_DISABLE_DEPRECATED_BEFORE=0x060000    # disables all the APIs deprecated before Qt 6.0.0
 
-SOURCES += \
-    chatdialog.cpp \
-    chatitemwidget.cpp \
-    chatlistwid.cpp \
-    global.cpp \
-    httpmgr.cpp \
-    logindialog.cpp \
-    main.cpp \
-    mainwindow.cpp \
-    registerdialog.cpp \
-    resetdialog.cpp \
-    tcpmgr.cpp \
-    timerbtn.cpp \
-    usermgr.cpp
-
-HEADERS += \
-    chatdialog.h \
-    chatitemdata.h \
-    chatitemwidget.h \
-    chatlistwid.h \
-    global.h \
-    httpmgr.h \
-    logindialog.h \
-    mainwindow.h \
-    registerdialog.h \
-    resetdialog.h \
-    singleton.h \
-    tcpmgr.h \
-    timerbtn.h \
-    usermgr.h
+include(baijiuchat.pri)
 
-FORMS += \
-    chatdialog.ui \
-    chatitemwidget.ui \
-    logindialog.ui \
-    mainwindow.ui \
-    registerdialog.ui \
-    resetdialog.ui
+SOURCES += \
+    main.cpp
 
 RC_ICONS = icon.ico # 窗口图标
 DESTDIR = ./bin # 存储文件
@@ -55,8 +21,35 @@ qnx: target.path = /tmp/$${TARGET}/bin
 else: unix:!android: target.path = /opt/$${TARGET}/bin
 !isEmpty(target.path): INSTALLS += target
 
-RESOURCES += \
-    rc.qrc
+# 头像资源
+# 默认把avatars/下的原图编进可执行文件。
+# CONFIG+=scaled_avatars：qmake阶段先用tools/avatarscaler把头像缩放到40px的1x/2x两档再打包，
+#   需要先构建该工具，路径可用AVATAR_SCALER=...覆盖。
+# CONFIG+=external_avatars：头像不编进可执行文件，构建时用rcc生成bin/avatars.rcc，启动时注册并内存映射。
+AVATAR_QRC = $$PWD/avatars.qrc
+scaled_avatars {
+    isEmpty(AVATAR_SCALER): AVATAR_SCALER = $$PWD/tools/avatarscaler/bin/avatarscaler
+    AVATAR_SCALED_DIR = $$OUT_PWD/avatars_scaled
+    AVATAR_ARGS =
+    for(avatar, $$list($$files($$PWD/avatars/*))): AVATAR_ARGS += $$shell_quote($$avatar)
+    !system($$shell_quote($$shell_path($$AVATAR_SCALER)) --out $$shell_quote($$AVATAR_SCALED_DIR) --size 40 --scales 1,2 $$AVATAR_ARGS) {
+        error("头像缩放失败：请先构建tools/avatarscaler，或用AVATAR_SCALER指定路径")
+    }
+    AVATAR_QRC = $$AVATAR_SCALED_DIR/avatars.qrc
+}
+external_avatars {
+    DEFINES += BAIJIU_EXTERNAL_AVATARS
+    AVATAR_RCC_DIR = $$shell_path($$OUT_PWD/bin)
+    avatars_rcc.target = avatars_rcc
+    avatars_rcc.depends = $$AVATAR_QRC
+    avatars_rcc.commands = $$sprintf($$QMAKE_MKDIR_CMD, $$shell_quote($$AVATAR_RCC_DIR)) $$escape_expand(\\n\\t) \
+        $$shell_quote($$shell_path($$[QT_HOST_LIBEXECS]/rcc)) -binary $$shell_quote($$AVATAR_QRC) \
+        -o $$shell_quote($$AVATAR_RCC_DIR/avatars.rcc)
+    QMAKE_EXTRA_TARGETS += avatars_rcc
+    PRE_TARGETDEPS += avatars_rcc
+} else {
+    RESOURCES += $$AVATAR_QRC
+}
 
 DISTFILES += \
     config.ini
@@ -0,0 +1,89 @@
+# 客户端除main.cpp以外的源文件，主程序和tests/下的压测目标共用
+QT += core gui network sql widgets
+
+CONFIG += c++17
+
+INCLUDEPATH += $$PWD
+
+SOURCES += \
+    $$PWD/baijiustyle.cpp \
+    $$PWD/chatdialog.cpp \
+    $$PWD/chatitemstore.cpp \
+    $$PWD/chatitemwidget.cpp \
+    $$PWD/chatlistwid.cpp \
+    $$PWD/chatsearchindex.cpp \
+    $$PWD/global.cpp \
+    $$PWD/httpmgr.cpp \
+    $$PWD/localdb.cpp \
+    $$PWD/logindialog.cpp \
+    $$PWD/mainwindow.cpp \
+    $$PWD/messagedelegate.cpp \
+    $$PWD/messagelistview.cpp \
+    $$PWD/messagemodel.cpp \
+    $$PWD/messagestore.cpp \
+    $$PWD/outboxmgr.cpp \
+    $$PWD/pinyintable.cpp \
+    $$PWD/registerdialog.cpp \
+    $$PWD/resetdialog.cpp \
+    $$PWD/searchmgr.cpp \
+    $$PWD/searchworker.cpp \
+    $$PWD/startuptracer.cpp \
+    $$PWD/tcpcapture.cpp \
+    $$PWD/tcpmgr.cpp \
+    $$PWD/tcpreplayer.cpp \
+    $$PWD/textlayoutcache.cpp \
+    $$PWD/thememgr.cpp \
+    $$PWD/timelabelmgr.cpp \
+    $$PWD/timerbtn.cpp \
+    $$PWD/unreadmgr.cpp \
+    $$PWD/usermgr.cpp
+
+HEADERS += \
+    $$PWD/baijiustyle.h \
+    $$PWD/chatdialog.h \
+    $$PWD/chatitemdata.h \
+    $$PWD/chatitemstore.h \
+    $$PWD/chatitemwidget.h \
+    $$PWD/chatlistwid.h \
+    $$PWD/chatsearchindex.h \
+    $$PWD/global.h \
+    $$PWD/httpmgr.h \
+    $$PWD/jsonschema.h \
+    $$PWD/localdb.h \
+    $$PWD/logindialog.h \
+    $$PWD/mainwindow.h \
+    $$PWD/messagedata.h \
+    $$PWD/messagedelegate.h \
+    $$PWD/messagelistview.h \
+    $$PWD/messagemodel.h \
+    $$PWD/messagestore.h \
+    $$PWD/msgdispatcher.h \
+    $$PWD/outboxmgr.h \
+    $$PWD/pinyintable.h \
+    $$PWD/registerdialog.h \
+    $$PWD/resetdialog.h \
+    $$PWD/searchmgr.h \
+    $$PWD/searchworker.h \
+    $$PWD/singleton.h \
+    $$PWD/startuptracer.h \
+    $$PWD/tcpcapture.h \
+    $$PWD/tcpmessages.h \
+    $$PWD/tcpmgr.h \
+    $$PWD/tcpreplayer.h \
+    $$PWD/textlayoutcache.h \
+    $$PWD/thememgr.h \
+    $$PWD/timelabelmgr.h \
+    $$PWD/timerbtn.h \
+    $$PWD/unreadmgr.h \
+    $$PWD/usermgr.h
+
+FORMS += \
+    $$PWD/chatdialog.ui \
+    $$PWD/chatitemwidget.ui \
+    $$PWD/logindialog.ui \
+    $$PWD/mainwindow.ui \
+    $$PWD/registerdialog.ui \
+    $$PWD/resetdialog.ui
+
+RESOURCES += \
+    $$PWD/rc.qrc
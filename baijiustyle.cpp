@@ -0,0 +1,274 @@
+#include "baijiustyle.h"
+#include "thememgr.h"
+#include <QStyleFactory>
+#include <QStyleOption>
+#include <QPainter>
+#include <QPushButton>
+#include <QToolButton>
+#include <QAbstractItemView>
+#include <QLabel>
+
+BaijiuStyle::BaijiuStyle() : QProxyStyle(QStyleFactory::create(QStringLiteral("Fusion")))
+{
+}
+
+bool BaijiuStyle::isThinScrollBar(const QWidget *widget)
+{
+    return widget && widget->property("thinScrollBar").toBool();
+}
+
+bool BaijiuStyle::isBadge(const QWidget *widget)
+{
+    if (!widget)
+        return false;
+    const QByteArray role = widget->property("themeRole").toByteArray();
+    return role == "badge" || role == "badgeSubtle";
+}
+
+bool BaijiuStyle::isChatList(const QWidget *widget)
+{
+    return widget && widget->property("themeRole").toByteArray() == "chatList";
+}
+
+// 每个控件只在第一次显示前走一次，之后切换主题也不会再进来
+void BaijiuStyle::polish(QWidget *widget)
+{
+    QProxyStyle::polish(widget);
+    if (qobject_cast<QAbstractButton*>(widget) || isThinScrollBar(widget))
+        widget->setAttribute(Qt::WA_Hover);
+    if (qobject_cast<QPushButton*>(widget)) {
+        QFont font = widget->font();
+        font.setFamily(QStringLiteral("Microsoft YaHei"));
+        font.setPixelSize(BUTTON_FONT_PX);
+        widget->setFont(font);
+    }
+    if (isChatList(widget)) {
+        if (QAbstractItemView *view = qobject_cast<QAbstractItemView*>(widget))
+            view->viewport()->setAttribute(Qt::WA_Hover);
+    }
+    ThemeMgr::GetInstance()->applyRole(widget);
+}
+
+void BaijiuStyle::drawPrimitive(PrimitiveElement element, const QStyleOption *option,
+                                QPainter *painter, const QWidget *widget) const
+{
+    const ThemeColors &colors = ThemeMgr::GetInstance()->colors();
+    switch (element) {
+    case PE_PanelButtonTool: {
+        // 工具按钮平时透明，悬停、按下、选中时才画底色
+        const bool down = option->state & (State_Sunken | State_On);
+        const bool hover = (option->state & State_MouseOver) && (option->state & State_Enabled);
+        if (!down && !hover)
+            return;
+        painter->save();
+        painter->setRenderHint(QPainter::Antialiasing);
+        painter->setPen(Qt::NoPen);
+        painter->setBrush(down ? colors.toolPressed : colors.toolHover);
+        painter->drawRoundedRect(QRectF(option->rect).adjusted(0.5, 0.5, -0.5, -0.5), TOOL_RADIUS, TOOL_RADIUS);
+        painter->restore();
+        return;
+    }
+    case PE_FrameFocusRect:
+        // 按钮和会话列表不画焦点虚线框
+        if (qobject_cast<const QAbstractButton*>(widget) || isChatList(widget))
+            return;
+        break;
+    case PE_FrameDefaultButton:
+        return;
+    case PE_PanelItemViewRow:
+        if (isChatList(widget))
+            return;
+        break;
+    case PE_PanelItemViewItem:
+        if (isChatList(widget)) {
+            const bool selected = option->state & State_Selected;
+            const bool hover = option->state & State_MouseOver;
+            if (!selected && !hover)
+                return;
+            painter->save();
+            painter->setRenderHint(QPainter::Antialiasing);
+            painter->setPen(Qt::NoPen);
+            painter->setBrush(selected ? colors.accent : colors.hover);
+            painter->drawRoundedRect(option->rect.adjusted(5, 2, -5, -2), ITEM_RADIUS, ITEM_RADIUS);
+            painter->restore();
+            return;
+        }
+        break;
+    default:
+        break;
+    }
+    QProxyStyle::drawPrimitive(element, option, painter, widget);
+}
+
+void BaijiuStyle::drawControl(ControlElement element, const QStyleOption *option,
+                              QPainter *painter, const QWidget *widget) const
+{
+    const ThemeColors &colors = ThemeMgr::GetInstance()->colors();
+    switch (element) {
+    case CE_PushButtonBevel:
+        if (const QStyleOptionButton *button = qstyleoption_cast<const QStyleOptionButton*>(option)) {
+            const bool down = option->state & (State_Sunken | State_On);
+            const bool hover = option->state & State_MouseOver;
+            QColor fill;
+            if (button->features & QStyleOptionButton::Flat) {
+                // 无边框按钮只有悬停反馈
+                if (!hover && !down)
+                    return;
+                fill = colors.flatHover;
+            } else {
+                fill = down ? colors.buttonPressed : (hover ? colors.buttonHover : colors.button);
+            }
+            painter->save();
+            painter->setRenderHint(QPainter::Antialiasing);
+            painter->setPen(Qt::NoPen);
+            painter->setBrush(fill);
+            painter->drawRoundedRect(option->rect, BUTTON_RADIUS, BUTTON_RADIUS);
+            painter->restore();
+            return;
+        }
+        break;
+    case CE_ShapedFrame:
+        if (isBadge(widget)) {
+            // 角标：用控件调色板的Window色填充圆角矩形
+            painter->save();
+            painter->setRenderHint(QPainter::Antialiasing);
+            painter->setPen(Qt::NoPen);
+            painter->setBrush(option->palette.color(QPalette::Window));
+            const qreal radius = qMin<qreal>(BADGE_RADIUS, option->rect.height() / 2.0);
+            painter->drawRoundedRect(option->rect, radius, radius);
+            painter->restore();
+            return;
+        }
+        if (widget) {
+            const QVariant edges = widget->property("borderEdges");
+            if (edges.isValid()) {
+                // 面板只在指定的边上画分隔线
+                const Qt::Edges sides = Qt::Edges(edges.toInt());
+                const QRect r = option->rect;
+                painter->save();
+                painter->setPen(colors.border);
+                if (sides & Qt::TopEdge)
+                    painter->drawLine(r.topLeft(), r.topRight());
+                if (sides & Qt::BottomEdge)
+                    painter->drawLine(r.bottomLeft(), r.bottomRight());
+                if (sides & Qt::LeftEdge)
+                    painter->drawLine(r.topLeft(), r.bottomLeft());
+                if (sides & Qt::RightEdge)
+                    painter->drawLine(r.topRight(), r.bottomRight());
+                painter->restore();
+                return;
+            }
+        }
+        break;
+    default:
+        break;
+    }
+    QProxyStyle::drawControl(element, option, painter, widget);
+}
+
+void BaijiuStyle::drawComplexControl(ComplexControl control, const QStyleOptionComplex *option,
+                                     QPainter *painter, const QWidget *widget) const
+{
+    if (control == CC_ScrollBar && isThinScrollBar(widget)) {
+        if (const QStyleOptionSlider *slider = qstyleoption_cast<const QStyleOptionSlider*>(option)) {
+            const ThemeColors &colors = ThemeMgr::GetInstance()->colors();
+            const bool hover = option->state & State_MouseOver;
+            const qreal radius = THIN_SCROLL_EXTENT / 2.0;
+            painter->save();
+            painter->setRenderHint(QPainter::Antialiasing);
+            painter->setPen(Qt::NoPen);
+            if (hover) {
+                painter->setBrush(colors.scrollTrack);
+                painter->drawRoundedRect(option->rect, radius, radius);
+            }
+            const bool handleActive = (slider->activeSubControls & SC_ScrollBarSlider)
+                                      && (option->state & (State_MouseOver | State_Sunken));
+            painter->setBrush(handleActive ? colors.scrollHandleHover : colors.scrollHandle);
+            painter->drawRoundedRect(thinScrollBarRect(slider, SC_ScrollBarSlider), radius, radius);
+            painter->restore();
+            return;
+        }
+    }
+    QProxyStyle::drawComplexControl(control, option, painter, widget);
+}
+
+// 细滚动条没有两端的箭头按钮，滑块长度按页长占比计算
+QRect BaijiuStyle::thinScrollBarRect(const QStyleOptionSlider *option, SubControl subControl) const
+{
+    const bool horizontal = option->orientation == Qt::Horizontal;
+    const QRect rect = option->rect;
+    const int length = horizontal ? rect.width() : rect.height();
+    const int range = option->maximum - option->minimum;
+    int sliderLength = length;
+    if (range > 0) {
+        sliderLength = int(qint64(length) * option->pageStep / (qint64(range) + option->pageStep));
+        sliderLength = qMin(qMax(sliderLength, SCROLL_HANDLE_MIN), length);
+    }
+    const int sliderStart = sliderPositionFromValue(option->minimum, option->maximum, option->sliderPosition,
+                                                    length - sliderLength, option->upsideDown);
+    int start = 0;
+    int end = length;
+    switch (subControl) {
+    case SC_ScrollBarSlider:
+        start = sliderStart;
+        end = sliderStart + sliderLength;
+        break;
+    case SC_ScrollBarSubPage:
+        end = sliderStart;
+        break;
+    case SC_ScrollBarAddPage:
+        start = sliderStart + sliderLength;
+        break;
+    case SC_ScrollBarGroove:
+        break;
+    default:
+        return QRect();
+    }
+    return horizontal ? QRect(rect.x() + start, rect.y(), end - start, rect.height())
+                      : QRect(rect.x(), rect.y() + start, rect.width(), end - start);
+}
+
+QRect BaijiuStyle::subControlRect(ComplexControl control, const QStyleOptionComplex *option,
+                                  SubControl subControl, const QWidget *widget) const
+{
+    if (control == CC_ScrollBar && isThinScrollBar(widget)) {
+        if (const QStyleOptionSlider *slider = qstyleoption_cast<const QStyleOptionSlider*>(option))
+            return thinScrollBarRect(slider, subControl);
+    }
+    return QProxyStyle::subControlRect(control, option, subControl, widget);
+}
+
+int BaijiuStyle::pixelMetric(PixelMetric metric, const QStyleOption *option, const QWidget *widget) const
+{
+    switch (metric) {
+    case PM_ScrollBarExtent:
+        if (isThinScrollBar(widget))
+            return THIN_SCROLL_EXTENT;
+        break;
+    case PM_ScrollBarSliderMin:
+        if (isThinScrollBar(widget))
+            return SCROLL_HANDLE_MIN;
+        break;
+    case PM_DefaultFrameWidth:
+        if (isBadge(widget))
+            return 0;
+        break;
+    case PM_ButtonShiftHorizontal:
+    case PM_ButtonShiftVertical:
+        return 1; // 按下时文字微移，制造按压感
+    default:
+        break;
+    }
+    return QProxyStyle::pixelMetric(metric, option, widget);
+}
+
+QSize BaijiuStyle::sizeFromContents(ContentsType type, const QStyleOption *option,
+                                    const QSize &size, const QWidget *widget) const
+{
+    if (type == CT_PushButton) {
+        QSize result = size + QSize(2 * BUTTON_PADDING_H, 2 * BUTTON_PADDING_V);
+        result.setWidth(qMax(result.width(), BUTTON_MIN_WIDTH));
+        return result;
+    }
+    return QProxyStyle::sizeFromContents(type, option, size, widget);
+}
@@ -0,0 +1,56 @@
+#ifndef BAIJIUSTYLE_H
+#define BAIJIUSTYLE_H
+#include <QProxyStyle>
+
+class QStyleOptionSlider;
+
+/**
+ * @brief 应用样式
+ * 代替原先的全局QSS：以Fusion为基础，按钮、工具按钮、会话列表项、细滚动条、
+ * 带边线的面板和角标直接用QPainter绘制，颜色取自ThemeMgr的当前主题。
+ * 控件通过动态属性选择外观：
+ *   themeRole   调色板角色（surface/chatList/tipError/badge/badgeSubtle），polish时解析
+ *   borderEdges 面板只画哪几条边（Qt::Edges）
+ *   thinScrollBar 细滚动条
+ */
+class BaijiuStyle : public QProxyStyle
+{
+    Q_OBJECT
+public:
+    BaijiuStyle();
+
+    void polish(QWidget *widget) override;
+    using QProxyStyle::polish;
+
+    void drawPrimitive(PrimitiveElement element, const QStyleOption *option,
+                       QPainter *painter, const QWidget *widget = nullptr) const override;
+    void drawControl(ControlElement element, const QStyleOption *option,
+                     QPainter *painter, const QWidget *widget = nullptr) const override;
+    void drawComplexControl(ComplexControl control, const QStyleOptionComplex *option,
+                            QPainter *painter, const QWidget *widget = nullptr) const override;
+    QRect subControlRect(ComplexControl control, const QStyleOptionComplex *option,
+                         SubControl subControl, const QWidget *widget = nullptr) const override;
+    int pixelMetric(PixelMetric metric, const QStyleOption *option = nullptr,
+                    const QWidget *widget = nullptr) const override;
+    QSize sizeFromContents(ContentsType type, const QStyleOption *option,
+                           const QSize &size, const QWidget *widget) const override;
+
+private:
+    static bool isThinScrollBar(const QWidget *widget);
+    static bool isBadge(const QWidget *widget);
+    static bool isChatList(const QWidget *widget);
+    QRect thinScrollBarRect(const QStyleOptionSlider *option, SubControl subControl) const;
+
+    static const int BUTTON_RADIUS = 4;        // 按钮圆角
+    static const int TOOL_RADIUS = 6;          // 工具按钮圆角
+    static const int ITEM_RADIUS = 4;          // 会话列表项圆角
+    static const int BADGE_RADIUS = 8;         // 角标圆角
+    static const int BUTTON_PADDING_H = 16;    // 按钮左右内边距
+    static const int BUTTON_PADDING_V = 8;     // 按钮上下内边距
+    static const int BUTTON_MIN_WIDTH = 60;    // 按钮最小宽度
+    static const int BUTTON_FONT_PX = 14;      // 按钮字号
+    static const int THIN_SCROLL_EXTENT = 4;   // 细滚动条宽度
+    static const int SCROLL_HANDLE_MIN = 20;   // 滑块最小长度
+};
+
+#endif // BAIJIUSTYLE_H
@@ -1,18 +1,46 @@
 #include "chatdialog.h"
 #include "ui_chatdialog.h"
 #include <QAction>
+#include <QDateTime>
+#include "searchmgr.h"
+#include "messagelistview.h"
+#include "tcpmgr.h"
+#include "outboxmgr.h"
+#include "messagestore.h"
+#include "unreadmgr.h"
+#include "thememgr.h"
 
 ChatDialog::ChatDialog(QWidget *parent)
     : QDialog(parent)
     , ui(new Ui::ChatDialog)
     , _mode(ChatUIMode::ChatMode)
     , _state(ChatUIMode::ChatMode)
+    , _searchGeneration(0)
+    , _firstResultLogged(false)
+    , _unreadBadge(nullptr)
 {
     ui->setupUi(this);
     // 设置图标
     setupNavigation();
     // 搜索的信号与槽
     initSearchSystem();
+    // 面板边线、背景和主题切换
+    initTheme();
+    // 未读角标
+    initUnreadBadge();
+    // 会话列表增量同步
+    connect(TcpMgr::GetInstance().get(), &TcpMgr::sig_chat_list_delta,
+            ui->chatListWid, &ChatListWid::applyChatListDelta);
+    // 推送的新消息：会话列表按帧合并更新，当前会话的消息列表直接追加
+    connect(TcpMgr::GetInstance().get(), &TcpMgr::sig_chat_message,
+            ui->chatListWid, &ChatListWid::applyIncomingMessage);
+    connect(TcpMgr::GetInstance().get(), &TcpMgr::sig_chat_message,
+            ui->messageListView, &MessageListView::appendIncoming);
+    // 选中会话后加载消息历史
+    connect(ui->chatListWid, &ChatListWid::sig_chat_selected,
+            ui->messageListView, &MessageListView::openConversation);
+    // 发送消息：先进发件箱，落盘后由发件箱发出
+    connect(ui->sendButton, &QPushButton::clicked, this, &ChatDialog::sendMessage);
     // 点击清除按钮（弃用）
     // connect(clearButton, &QAction::triggered, [=](){
     //     ui->searchEdit->clear();
@@ -68,7 +96,8 @@ void ChatDialog::initSearchSystem() {
     // 初始化定时器
     searchTimer = new QTimer(this);
     searchTimer->setSingleShot(true);
-    searchTimer->setInterval(500); // 500ms防抖间隔
+    // 查询在搜索线程上执行，防抖只用来把同一帧内的连续输入合并成一次查询
+    searchTimer->setInterval(SEARCH_DEBOUNCE_MS);
 
     // 连接信号槽
     connect(ui->searchEdit, &QLineEdit::textChanged, [=](const QString &text){
@@ -77,16 +106,148 @@ void ChatDialog::initSearchSystem() {
         ui->searchListWid->setVisible(_mode == ChatUIMode::SearchMode);
         ui->chatListWid->setVisible(_mode == ChatUIMode::ChatMode);
 
+        // 从按键开始计时，包含防抖和排队时间
+        _keystrokeClock.start();
+        if (_mode == ChatUIMode::ChatMode) {
+            searchTimer->stop();
+            SearchMgr::GetInstance()->cancelSearch();
+            _searchGeneration = 0;
+            return;
+        }
         // 触发防抖搜索
         searchTimer->start();
     });
 
     // 防抖搜索逻辑
-    // connect(searchTimer, &QTimer::timeout, [=](){
-    //     if(_mode == ChatUIMode::SearchMode) {
-    //         refreshSearchList(ui->searchEdit->text());
-    //     }
-    // });
+    connect(searchTimer, &QTimer::timeout, [=](){
+        if(_mode == ChatUIMode::SearchMode) {
+            refreshSearchList(ui->searchEdit->text());
+        }
+    });
+
+    // 搜索线程分批返回的结果
+    connect(SearchMgr::GetInstance().get(), &SearchMgr::sig_search_results,
+            this, &ChatDialog::onSearchResults);
+
+    // 点击搜索结果：退出搜索并选中对应会话
+    connect(ui->searchListWid, &QListWidget::itemClicked, [=](QListWidgetItem *item){
+        int id = item->data(Qt::UserRole).toInt();
+        ui->searchEdit->clear();
+        ui->chatListWid->selectChat(id);
+    });
+}
+
+// 发起查询，之前未完成的查询随之取消
+void ChatDialog::refreshSearchList(const QString &text)
+{
+    _searchGeneration = SearchMgr::GetInstance()->requestSearch(text);
+    _firstResultLogged = false;
+}
+
+// 每批结果都是当前的前k条，整体替换列表内容
+void ChatDialog::onSearchResults(int generation, const QVector<SearchHit> &hits, bool finished)
+{
+    if (generation != _searchGeneration || _mode != ChatUIMode::SearchMode)
+        return;
+
+    if (!_firstResultLogged) {
+        _firstResultLogged = true;
+        qDebug() << "搜索首批结果:" << hits.size() << "条, 距按键" << _keystrokeClock.elapsed() << "ms";
+    }
+    if (finished) {
+        qDebug() << "搜索完成:" << hits.size() << "条, 距按键" << _keystrokeClock.elapsed() << "ms";
+    }
+
+    const ChatItemStore &store = ui->chatListWid->chatItemStore();
+    ui->searchListWid->setUpdatesEnabled(false);
+    ui->searchListWid->clear();
+    for (const SearchHit &hit : hits) {
+        int slot = store.slotOf(hit.id);
+        if (slot < 0)
+            continue;
+        QListWidgetItem *item = new QListWidgetItem(store.nameAt(slot), ui->searchListWid);
+        item->setToolTip(store.previewAt(slot));
+        item->setData(Qt::UserRole, hit.id);
+    }
+    ui->searchListWid->setUpdatesEnabled(true);
+}
+
+// 发出的消息立即显示在本地，投递由发件箱保证（至少一次）
+void ChatDialog::sendMessage()
+{
+    const QString text = ui->textEdit->toPlainText().trimmed();
+    const int chatId = ui->messageListView->chatId();
+    if (text.isEmpty() || chatId < 0)
+        return;
+    const qint64 now = QDateTime::currentMSecsSinceEpoch();
+    if (OutboxMgr::GetInstance()->enqueue(chatId, text, now) < 0) {
+        qDebug() << "发件箱未打开或已满，消息未发送";
+        return;
+    }
+    MessageData message = MessageStore::GetInstance()->appendMessage(chatId, true, text, now);
+    ui->messageListView->appendIncoming(message);
+    ui->chatListWid->applyIncomingMessage(message);
+    ui->textEdit->clear();
+}
+
+// 原QSS里按objectName写的边线和背景改为动态属性，由BaijiuStyle在polish和绘制时读取
+void ChatDialog::initTheme()
+{
+    ui->messageListView->setProperty("themeRole", "surface");
+    ui->messageListView->setProperty("borderEdges", int(Qt::TopEdge | Qt::BottomEdge));
+    ui->textEdit->setProperty("themeRole", "surface");
+    ui->textEdit->setProperty("borderEdges", 0);
+    for (QWidget *list : {static_cast<QWidget*>(ui->searchListWid), static_cast<QWidget*>(ui->contactListWid)}) {
+        list->setProperty("themeRole", "surface");
+        list->setProperty("borderEdges", int(Qt::RightEdge));
+    }
+
+    // 右键侧边栏logo切换深浅主题
+    QAction *toggleTheme = new QAction(tr("切换深色/浅色主题"), ui->logoLabel);
+    ui->logoLabel->addAction(toggleTheme);
+    ui->logoLabel->setContextMenuPolicy(Qt::ActionsContextMenu);
+    connect(toggleTheme, &QAction::triggered, this, []() {
+        ThemeMgr::GetInstance()->toggleTheme();
+    });
+}
+
+void ChatDialog::initUnreadBadge()
+{
+    _unreadBadge = new QLabel(ui->chatSectionBtn);
+    _unreadBadge->setObjectName("sectionBadge");
+    _unreadBadge->setProperty("themeRole", "badge"); // 先设角色，边框宽度按角标计算
+    _unreadBadge->setFrameShape(QFrame::StyledPanel);
+    _unreadBadge->setContentsMargins(4, 0, 4, 0);
+    _unreadBadge->setFixedHeight(16);
+    QFont badgeFont = _unreadBadge->font();
+    badgeFont.setPointSize(8);
+    _unreadBadge->setFont(badgeFont);
+    _unreadBadge->setAlignment(Qt::AlignCenter);
+    _unreadBadge->setAttribute(Qt::WA_TransparentForMouseEvents);
+    _unreadBadge->hide();
+
+    // 右键聊天分区按钮：全部标为已读
+    QAction *markAllRead = new QAction(tr("全部标为已读"), ui->chatSectionBtn);
+    ui->chatSectionBtn->addAction(markAllRead);
+    ui->chatSectionBtn->setContextMenuPolicy(Qt::ActionsContextMenu);
+    connect(markAllRead, &QAction::triggered, ui->chatListWid, &ChatListWid::markAllRead);
+
+    connect(UnreadMgr::GetInstance().get(), &UnreadMgr::sig_unread_changed, this, &ChatDialog::onUnreadChanged);
+    onUnreadChanged(UnreadMgr::GetInstance()->totals());
+}
+
+// 角标只统计未免打扰的会话
+void ChatDialog::onUnreadChanged(const UnreadTotals &totals)
+{
+    if (totals.unmuted <= 0) {
+        _unreadBadge->hide();
+        return;
+    }
+    _unreadBadge->setText(totals.unmuted > 99 ? "99+" : QString::number(totals.unmuted));
+    _unreadBadge->adjustSize();
+    _unreadBadge->resize(qMax(_unreadBadge->width(), _unreadBadge->height()), _unreadBadge->height());
+    _unreadBadge->move(ui->chatSectionBtn->width() - _unreadBadge->width() - 2, 2);
+    _unreadBadge->show();
 }
 
 ChatDialog::~ChatDialog()
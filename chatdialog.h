@@ -4,6 +4,10 @@
 #include <QDialog>
 #include "global.h"
 #include <QTimer>
+#include <QElapsedTimer>
+#include <QLabel>
+#include "chatsearchindex.h"
+#include "chatitemdata.h"
 
 namespace Ui {
 class ChatDialog;
@@ -23,9 +27,21 @@ private:
     ChatUIMode _mode;
     ChatUIMode _state;
     QTimer* searchTimer;  // 防抖定时器
+    int _searchGeneration;  // 当前查询的代号，其余代号的结果直接丢弃
+    QElapsedTimer _keystrokeClock;  // 最近一次按键的计时
+    bool _firstResultLogged;  // 当前查询是否已记录首批结果延迟
+    QLabel *_unreadBadge;  // 聊天分区按钮上的未读角标
 
     void setupNavigation();
     void initSearchSystem();
+    void refreshSearchList(const QString &text);
+    void initUnreadBadge();
+    void initTheme();
+    void sendMessage();
+    void onUnreadChanged(const UnreadTotals &totals);
+    void onSearchResults(int generation, const QVector<SearchHit> &hits, bool finished);
+
+    static const int SEARCH_DEBOUNCE_MS = 16; // 搜索防抖间隔（一帧）
 };
 
 #endif // CHATDIALOG_H
@@ -4,6 +4,8 @@
 #include <QDateTime>
 #include <QString>
 #include <QPixmap>
+#include <QVector>
+#include <QPair>
 
 // 聊天项数据结构
 struct ChatItemData {
@@ -15,6 +17,7 @@ struct ChatItemData {
     int unreadCount;            // 未读消息数
     bool muted;                 // 是否免打扰
     bool isValid;               // 是否有效(用于过滤)
+    bool isGroup;               // 是否为群聊
 
     // 构造函数
     ChatItemData(int _id = 0,
@@ -24,12 +27,37 @@ struct ChatItemData {
                  const QDateTime &_time = QDateTime::currentDateTime(),
                  int _unread = 0,
                  bool _muted = false,
-                 bool _valid = true)
+                 bool _valid = true,
+                 bool _group = false)
         : id(_id), avatarPath(_avatar), name(_name),
         lastMessage(_lastMsg), lastMessageTime(_time),
-        unreadCount(_unread), muted(_muted), isValid(_valid)
+        unreadCount(_unread), muted(_muted), isValid(_valid), isGroup(_group)
     {}
 };
 
+// 未读数汇总
+struct UnreadTotals {
+    int all;        // 全部未读
+    int unmuted;    // 未免打扰会话的未读（角标显示这个）
+    int groups;     // 群聊未读
+    int direct;     // 单聊未读
+
+    UnreadTotals() : all(0), unmuted(0), groups(0), direct(0) {}
+    bool operator==(const UnreadTotals &other) const {
+        return all == other.all && unmuted == other.unmuted
+               && groups == other.groups && direct == other.direct;
+    }
+    bool operator!=(const UnreadTotals &other) const { return !(*this == other); }
+};
+
+// 会话列表的一批增量（一次同步响应）
+struct ChatListDelta {
+    qint64 cursor;                          // 应用后的同步游标
+    QVector<ChatItemData> upserts;          // 新增或内容变化的会话
+    QVector<int> removes;                   // 被删除的会话
+    QVector<QPair<int, int>> unreadChanges; // 只有未读数变化的会话：(id, 未读数)
+
+    ChatListDelta() : cursor(0) {}
+};
 
 #endif // CHATITEMDATA_H
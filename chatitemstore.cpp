@@ -0,0 +1,187 @@
+#include "chatitemstore.h"
+
+// 驻留字符串，已存在则返回原有下标
+quint32 StringPool::intern(const QString &str)
+{
+    auto it = m_index.constFind(str);
+    if (it != m_index.constEnd())
+        return it.value();
+    quint32 key = static_cast<quint32>(m_strings.size());
+    m_strings.append(str);
+    m_index.insert(str, key);
+    return key;
+}
+
+void StringPool::clear()
+{
+    m_strings.clear();
+    m_index.clear();
+}
+
+// 字符串内容加上索引哈希的开销
+qint64 StringPool::memoryBytes() const
+{
+    qint64 bytes = m_strings.capacity() * qint64(sizeof(QString));
+    for (const QString &str : m_strings) {
+        bytes += str.capacity() * qint64(sizeof(QChar)) + 24; // 24字节为堆上的数据头
+    }
+    bytes += m_index.capacity() * qint64(sizeof(QString) + sizeof(quint32) + sizeof(void*));
+    return bytes;
+}
+
+// 会话转换为完整结构
+ChatItemData ChatItemRef::toData() const
+{
+    if (isNull())
+        return ChatItemData(0, "", "", "", QDateTime(), 0, false, false);
+    return ChatItemData(id(), avatarPath(), name(), lastMessage(), lastMessageTime(),
+                        unreadCount(), muted(), isValid(), isGroup());
+}
+
+void ChatItemStore::clear()
+{
+    m_ids.clear();
+    m_timeMs.clear();
+    m_avatarKeys.clear();
+    m_nameKeys.clear();
+    m_previews.clear();
+    m_state.clear();
+    m_freeSlots.clear();
+    m_slotById.clear();
+    m_avatars.clear();
+    m_names.clear();
+    m_unreadTotals = UnreadTotals();
+}
+
+void ChatItemStore::reserve(int count)
+{
+    m_ids.reserve(count);
+    m_timeMs.reserve(count);
+    m_avatarKeys.reserve(count);
+    m_nameKeys.reserve(count);
+    m_previews.reserve(count);
+    m_state.reserve(count);
+    m_slotById.reserve(count);
+}
+
+// 插入会话，优先复用空槽
+int ChatItemStore::insert(const ChatItemData &data)
+{
+    int slot;
+    if (!m_freeSlots.isEmpty()) {
+        slot = m_freeSlots.takeLast();
+    } else {
+        slot = m_ids.size();
+        m_ids.append(0);
+        m_timeMs.append(0);
+        m_avatarKeys.append(0);
+        m_nameKeys.append(0);
+        m_previews.append(QString());
+        m_state.append(0);
+    }
+    write(slot, data);
+    m_slotById.insert(data.id, slot);
+    return slot;
+}
+
+void ChatItemStore::update(int slot, const ChatItemData &data)
+{
+    if (slot < 0 || slot >= m_ids.size())
+        return;
+    if (m_ids[slot] != data.id) {
+        m_slotById.remove(m_ids[slot]);
+        m_slotById.insert(data.id, slot);
+    }
+    write(slot, data);
+}
+
+void ChatItemStore::remove(int slot)
+{
+    if (slot < 0 || slot >= m_ids.size() || !validAt(slot))
+        return;
+    accumulateUnread(slot, -1);
+    m_slotById.remove(m_ids[slot]);
+    m_previews[slot] = QString(); // 释放预览文本
+    m_state[slot] = 0;
+    m_freeSlots.append(slot);
+}
+
+QVector<int> ChatItemStore::validSlots() const
+{
+    QVector<int> result;
+    result.reserve(size());
+    for (int i = 0; i < m_state.size(); ++i) {
+        if (m_state[i] & FLAG_VALID)
+            result.append(i);
+    }
+    return result;
+}
+
+int ChatItemStore::clearUnread()
+{
+    int cleared = 0;
+    for (quint32 &state : m_state) {
+        if ((state & FLAG_VALID) && (state & UNREAD_MASK)) {
+            state &= ~UNREAD_MASK;
+            ++cleared;
+        }
+    }
+    m_unreadTotals = UnreadTotals();
+    return cleared;
+}
+
+void ChatItemStore::accumulateUnread(int slot, int sign)
+{
+    const quint32 state = m_state[slot];
+    const int unread = int(state & UNREAD_MASK);
+    if (!(state & FLAG_VALID) || unread == 0)
+        return;
+    m_unreadTotals.all += sign * unread;
+    if (!(state & FLAG_MUTED))
+        m_unreadTotals.unmuted += sign * unread;
+    if (state & FLAG_GROUP)
+        m_unreadTotals.groups += sign * unread;
+    else
+        m_unreadTotals.direct += sign * unread;
+}
+
+void ChatItemStore::write(int slot, const ChatItemData &data)
+{
+    accumulateUnread(slot, -1); // 新槽位或空槽的状态为0，不影响汇总
+    m_ids[slot] = data.id;
+    m_timeMs[slot] = data.lastMessageTime.toMSecsSinceEpoch();
+    m_avatarKeys[slot] = m_avatars.intern(data.avatarPath);
+    m_nameKeys[slot] = m_names.intern(data.name);
+    m_previews[slot] = data.lastMessage;
+    m_state[slot] = packState(data);
+    accumulateUnread(slot, 1);
+}
+
+quint32 ChatItemStore::packState(const ChatItemData &data)
+{
+    quint32 unread = static_cast<quint32>(qBound(0, data.unreadCount, int(UNREAD_MASK)));
+    quint32 state = unread | FLAG_VALID;
+    if (data.muted)
+        state |= FLAG_MUTED;
+    if (data.isGroup)
+        state |= FLAG_GROUP;
+    return state;
+}
+
+// 各列容量加上驻留池和预览文本
+qint64 ChatItemStore::memoryBytes() const
+{
+    qint64 bytes = m_ids.capacity() * qint64(sizeof(int))
+                   + m_timeMs.capacity() * qint64(sizeof(qint64))
+                   + m_avatarKeys.capacity() * qint64(sizeof(quint32))
+                   + m_nameKeys.capacity() * qint64(sizeof(quint32))
+                   + m_previews.capacity() * qint64(sizeof(QString))
+                   + m_state.capacity() * qint64(sizeof(quint32))
+                   + m_freeSlots.capacity() * qint64(sizeof(int))
+                   + m_slotById.capacity() * qint64(sizeof(int) * 2 + sizeof(void*));
+    for (const QString &preview : m_previews) {
+        if (!preview.isEmpty())
+            bytes += preview.capacity() * qint64(sizeof(QChar)) + 24;
+    }
+    return bytes + m_avatars.memoryBytes() + m_names.memoryBytes();
+}
@@ -0,0 +1,131 @@
+#ifndef CHATITEMSTORE_H
+#define CHATITEMSTORE_H
+
+#include <QVector>
+#include <QHash>
+#include <QString>
+#include <QDateTime>
+#include "chatitemdata.h"
+
+class ChatItemStore;
+
+// 字符串驻留池：相同的头像路径、名称只保存一份
+class StringPool
+{
+public:
+    quint32 intern(const QString &str);
+    const QString &at(quint32 key) const { return m_strings[key]; }
+    int size() const { return m_strings.size(); }
+    void clear();
+    qint64 memoryBytes() const;
+
+private:
+    QVector<QString> m_strings;
+    QHash<QString, quint32> m_index;
+};
+
+// 会话行视图：只持有存储指针和槽位，按需读取各列
+class ChatItemRef
+{
+public:
+    ChatItemRef(const ChatItemStore *store = nullptr, int slot = -1) : m_store(store), m_slot(slot) {}
+
+    bool isNull() const { return !m_store || m_slot < 0; }
+    int slot() const { return m_slot; }
+    inline int id() const;
+    inline const QString &avatarPath() const;
+    inline const QString &name() const;
+    inline const QString &lastMessage() const;
+    inline qint64 lastMessageMs() const;
+    QDateTime lastMessageTime() const { return QDateTime::fromMSecsSinceEpoch(lastMessageMs()); }
+    inline int unreadCount() const;
+    inline bool muted() const;
+    inline bool isGroup() const;
+    inline bool isValid() const;
+    // 转换为完整数据结构（只在绑定控件等少量场景使用）
+    ChatItemData toData() const;
+
+private:
+    const ChatItemStore *m_store;
+    int m_slot;
+};
+
+// 列式会话存储：每列一个连续数组，字符串驻留，时间存为毫秒时间戳，
+// 未读数和标志位打包进一个32位整数。预览按原文保存：行数据会原样写回本地库和搜索索引，
+// 只在显示时按宽度省略
+class ChatItemStore
+{
+public:
+    static const quint32 UNREAD_MASK = 0x00FFFFFF; // 低24位：未读数（饱和）
+    static const quint32 FLAG_MUTED = 1u << 24; // 免打扰
+    static const quint32 FLAG_VALID = 1u << 25; // 槽位有效
+    static const quint32 FLAG_GROUP = 1u << 26; // 群聊
+
+    void clear();
+    void reserve(int count);
+    // 槽位总数（包括已删除的空槽）
+    int slotCount() const { return m_ids.size(); }
+    // 有效会话数
+    int size() const { return m_slotById.size(); }
+
+    // 插入会话，返回槽位
+    int insert(const ChatItemData &data);
+    // 覆盖指定槽位的数据
+    void update(int slot, const ChatItemData &data);
+    // 删除槽位，空槽留给后续插入复用
+    void remove(int slot);
+    // 按会话id查找槽位，不存在返回-1
+    int slotOf(int id) const { return m_slotById.value(id, -1); }
+    // 所有有效槽位
+    QVector<int> validSlots() const;
+    // 未读数汇总，随插入、更新、删除增量维护
+    const UnreadTotals &unreadTotals() const { return m_unreadTotals; }
+    // 所有会话未读清零，返回被清零的会话数
+    int clearUnread();
+
+    ChatItemRef row(int slot) const { return ChatItemRef(this, slot); }
+
+    // 列访问
+    int idAt(int slot) const { return m_ids[slot]; }
+    qint64 timeMsAt(int slot) const { return m_timeMs[slot]; }
+    const QString &avatarAt(int slot) const { return m_avatars.at(m_avatarKeys[slot]); }
+    const QString &nameAt(int slot) const { return m_names.at(m_nameKeys[slot]); }
+    const QString &previewAt(int slot) const { return m_previews[slot]; }
+    int unreadAt(int slot) const { return int(m_state[slot] & UNREAD_MASK); }
+    bool mutedAt(int slot) const { return m_state[slot] & FLAG_MUTED; }
+    bool validAt(int slot) const { return m_state[slot] & FLAG_VALID; }
+    bool groupAt(int slot) const { return m_state[slot] & FLAG_GROUP; }
+
+    // 估算占用的字节数
+    qint64 memoryBytes() const;
+
+private:
+    void write(int slot, const ChatItemData &data);
+    static quint32 packState(const ChatItemData &data);
+    // 把槽位的未读数计入（sign为1）或移出（sign为-1）汇总
+    void accumulateUnread(int slot, int sign);
+
+    QVector<int> m_ids;
+    QVector<qint64> m_timeMs;
+    QVector<quint32> m_avatarKeys;
+    QVector<quint32> m_nameKeys;
+    QVector<QString> m_previews;
+    QVector<quint32> m_state;
+    QVector<int> m_freeSlots;
+    QHash<int, int> m_slotById;
+    StringPool m_avatars;
+    StringPool m_names;
+    UnreadTotals m_unreadTotals;
+};
+
+int ChatItemRef::id() const { return m_store->idAt(m_slot); }
+const QString &ChatItemRef::avatarPath() const { return m_store->avatarAt(m_slot); }
+const QString &ChatItemRef::name() const { return m_store->nameAt(m_slot); }
+const QString &ChatItemRef::lastMessage() const { return m_store->previewAt(m_slot); }
+qint64 ChatItemRef::lastMessageMs() const { return m_store->timeMsAt(m_slot); }
+int ChatItemRef::unreadCount() const { return m_store->unreadAt(m_slot); }
+bool ChatItemRef::muted() const { return m_store->mutedAt(m_slot); }
+bool ChatItemRef::isValid() const { return m_store->validAt(m_slot); }
+bool ChatItemRef::isGroup() const { return m_store->groupAt(m_slot); }
+
+#endif // CHATITEMSTORE_H
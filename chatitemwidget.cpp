@@ -1,25 +1,29 @@
 #include "chatitemwidget.h"
 #include "ui_chatitemwidget.h"
+#include "textlayoutcache.h"
+#include "timelabelmgr.h"
+#include "startuptracer.h"
+#include "thememgr.h"
 
 #include <QPainter>
 #include <QPainterPath>
 #include <QDate>
-#include <QFontMetrics>
 #include <QCache>
+#include <QFile>
 
-// 定义静态头像缓存，最大缓存100个头像
-QCache<QString, QPixmap> ChatItemWidget::avatarCache(50); // 缓存 x 个头像
+// 定义静态头像缓存，按设备像素比分开缓存，窗口换到不同缩放的屏幕后重新生成
+QCache<QPair<QString, qreal>, QPixmap> ChatItemWidget::avatarCache(50); // 缓存 x 个头像
 
 // 构造函数，初始化聊天项控件
 ChatItemWidget::ChatItemWidget(const ChatItemData &data, QWidget *parent)
-    : QWidget(parent), ui(new Ui::ChatItemWidget), m_data(data), m_isSelected(false), m_isFullyLoaded(false)
+    : QWidget(parent), ui(new Ui::ChatItemWidget), m_data(data), m_isSelected(false), m_isFullyLoaded(false),
+    m_timeBucket(TIME_OLDER)
 {
     ui->setupUi(this);  // 设置UI界面
     initUI();  // 初始化UI组件
     // 设置名称标签的省略显示文本
-    QFontMetrics nameMetrics(ui->m_nameLabel->font());
-    QString nameElided = nameMetrics.elidedText(m_data.name, Qt::ElideRight, ui->m_nameLabel->width());
-    ui->m_nameLabel->setText(nameElided);
+    ui->m_nameLabel->setText(TextLayoutCache::GetInstance()->elidedText(
+        m_data.name, ui->m_nameLabel->font(), ui->m_nameLabel->width()));
 }
 
 // 析构函数
@@ -34,10 +38,9 @@ void ChatItemWidget::updateData(const ChatItemData &data)
 {
     m_data = data;  // 更新数据
     m_isFullyLoaded = false;  // 标记为未完全加载
-    // 更新名称标签的省略显示文本
-    QFontMetrics nameMetrics(ui->m_nameLabel->font());
-    QString nameElided = nameMetrics.elidedText(m_data.name, Qt::ElideRight, ui->m_nameLabel->width());
-    ui->m_nameLabel->setText(nameElided);
+    // 更新名称标签的省略显示文本（走共享缓存）
+    ui->m_nameLabel->setText(TextLayoutCache::GetInstance()->elidedText(
+        m_data.name, ui->m_nameLabel->font(), ui->m_nameLabel->width()));
     // 根据可见性决定加载或卸载数据
     if (isVisible()) {
         loadFullData();
@@ -52,13 +55,16 @@ void ChatItemWidget::loadFullData()
     if (m_isFullyLoaded)  // 如果已经加载则直接返回
         return;
 
-    // 加载头像（优先从缓存获取）
+    // 加载头像（优先从缓存获取），高分屏取预缩放的@2x版本
+    const qreal dpr = devicePixelRatioF();
+    const QPair<QString, qreal> cacheKey(m_data.avatarPath, dpr);
     QPixmap avatar;
-    if (avatarCache.contains(m_data.avatarPath)) {  // 检查缓存中是否有该头像
-        avatar = *avatarCache[m_data.avatarPath];  // 从缓存获取头像
+    if (QPixmap *cached = avatarCache.object(cacheKey)) {  // 检查缓存中是否有该头像
+        avatar = *cached;  // 从缓存获取头像
     } else {
+        TracePhase phase("解码头像");
         // 从文件加载头像
-        avatar = QPixmap(m_data.avatarPath);
+        avatar = QPixmap(avatarPathForScale(m_data.avatarPath, dpr));
         if (avatar.isNull()) {  // 如果加载失败
             // 尝试加载默认头像
             avatar = QPixmap(":/LogReg/avatars/default_avatar.png");
@@ -69,19 +75,20 @@ void ChatItemWidget::loadFullData()
             }
         }
         // 将头像处理为圆形并加入缓存
-        QPixmap *cachedAvatar = new QPixmap(createCircularPixmap(avatar, 40));
-        avatarCache.insert(m_data.avatarPath, cachedAvatar);
+        QPixmap *cachedAvatar = new QPixmap(createCircularPixmap(avatar, AVATAR_SIZE, dpr));
+        avatarCache.insert(cacheKey, cachedAvatar);
         avatar = *cachedAvatar;
     }
     ui->m_avatarLabel->setPixmap(avatar);  // 设置头像
 
-    // 加载消息并设置省略显示
-    QFontMetrics msgMetrics(ui->m_messageLabel->font());
-    QString msgElided = msgMetrics.elidedText(m_data.lastMessage, Qt::ElideRight, ui->m_messageLabel->width());
-    ui->m_messageLabel->setText(msgElided);
+    // 加载消息并设置省略显示（走共享缓存）
+    ui->m_messageLabel->setText(TextLayoutCache::GetInstance()->elidedText(
+        m_data.lastMessage, ui->m_messageLabel->font(), ui->m_messageLabel->width()));
 
     // 加载并格式化时间
-    ui->m_timeLabel->setText(formatTime(m_data.lastMessageTime));
+    qint64 timeMs = m_data.lastMessageTime.toMSecsSinceEpoch();
+    m_timeBucket = TimeLabelMgr::GetInstance()->bucket(timeMs);
+    ui->m_timeLabel->setText(TimeLabelMgr::GetInstance()->label(timeMs));
 
     // 更新通知状态（未读消息、静音等）
     updateNotificationStatus();
@@ -94,10 +101,7 @@ void ChatItemWidget::unloadData()
 {
     if (!m_isFullyLoaded)  // 如果未加载则直接返回
         return;
-    // 移除缓存中的头像
-    if (avatarCache.contains(m_data.avatarPath)) {
-        avatarCache.remove(m_data.avatarPath);
-    }
+    // 头像缓存由多行共享且有容量上限，这里不再移除，避免控件复用时反复解码
     ui->m_avatarLabel->setPixmap(QPixmap()); // 清空头像
     ui->m_messageLabel->setText("");  // 清空消息
     ui->m_timeLabel->setText("");  // 清空时间
@@ -107,58 +111,54 @@ void ChatItemWidget::unloadData()
     m_isFullyLoaded = false;  // 标记为未加载
 }
 
-// 设置选中状态
+// 设置选中状态：只替换预先构建的调色板并重绘一次，不再重新解析样式表
 void ChatItemWidget::setSelected(bool selected)
 {
+    if (m_isSelected == selected)
+        return;
     m_isSelected = selected;
-    if (selected) {
-        // 选中状态的样式表
-        setStyleSheet(
-            "QWidget {"
-            "   background-color: #A2A2FE;"
-            "   border-radius: 4px;"
-            "   color: white;"
-            "}"
-            "QLabel { color: white; }"
-            );
-        // 设置消息和时间标签的特殊样式
-        ui->m_messageLabel->setStyleSheet("color: rgba(255, 255, 255, 0.8); font-size: 9pt;");
-        ui->m_timeLabel->setStyleSheet("color: rgba(255, 255, 255, 0.8); font-size: 8pt;");
-    } else {
-        // 未选中状态的样式表
-        setStyleSheet(
-            "QWidget {"
-            "   background-color: transparent;"
-            "   border-radius: 4px;"
-            "}"
-            );
-        // 重置各标签的样式
-        ui->m_nameLabel->setStyleSheet("");
-        ui->m_messageLabel->setStyleSheet("color: #666666; font-size: 9pt;");
-        ui->m_timeLabel->setStyleSheet("color: #888888; font-size: 8pt;");
-        ui->m_unreadLabel->setStyleSheet(
-            "background-color: #C7C7C7;"
-            "color: white;"
-            "border-radius: 8px;"
-            "padding: 0 4px;"
-            "font-size: 8pt;"
-            );
-    }
+    applyLabelPalettes();
+    update();
+}
+
+// 选中背景直接绘制
+void ChatItemWidget::paintEvent(QPaintEvent *event)
+{
+    Q_UNUSED(event);
+    if (!m_isSelected)
+        return;
+    QPainter painter(this);
+    painter.setRenderHint(QPainter::Antialiasing, true);
+    painter.setPen(Qt::NoPen);
+    painter.setBrush(ThemeMgr::GetInstance()->colors().accent);
+    painter.drawRoundedRect(rect(), 4, 4);
+}
+
+// 按选中状态给文字标签设置调色板
+void ChatItemWidget::applyLabelPalettes()
+{
+    // 调色板由主题服务预先构建，所有控件共享
+    std::shared_ptr<ThemeMgr> theme = ThemeMgr::GetInstance();
+    ui->m_nameLabel->setPalette(theme->textPalette(m_isSelected ? ThemeMgr::TEXT_SELECTED : ThemeMgr::TEXT_NAME));
+    ui->m_messageLabel->setPalette(theme->textPalette(m_isSelected ? ThemeMgr::TEXT_SELECTED_DIM : ThemeMgr::TEXT_MESSAGE));
+    ui->m_timeLabel->setPalette(theme->textPalette(m_isSelected ? ThemeMgr::TEXT_SELECTED_DIM : ThemeMgr::TEXT_TIME));
+    ui->m_mutedLabel->setPalette(theme->textPalette(m_isSelected ? ThemeMgr::TEXT_SELECTED_DIM : ThemeMgr::TEXT_TIME));
+}
+
+// 主题切换后重设文字颜色并重绘
+void ChatItemWidget::refreshTheme()
+{
+    applyLabelPalettes();
+    update();
 }
 
 // 初始化UI组件
 void ChatItemWidget::initUI()
 {
     ui->m_mutedLabel->hide();  // 隐藏静音图标
-    // 设置未读计数标签的样式
-    ui->m_unreadLabel->setStyleSheet(
-        "background-color: #C7C7C7;"
-        "color: white;"
-        "border-radius: 8px;"
-        "padding: 0 4px;"
-        "font-size: 8pt;"
-        );
-    ui->m_unreadLabel->hide();  // 隐藏未读计数
+    ui->m_unreadLabel->hide();  // 隐藏未读计数（角标外观由themeRole属性决定）
+    ui->m_unreadLabel->setContentsMargins(4, 0, 4, 0);
+    applyLabelPalettes();
     ui->m_avatarLabel->setPixmap(QPixmap());  // 清空头像
     ui->m_messageLabel->setText("");  // 清空消息
     ui->m_timeLabel->setText("");  // 清空时间
@@ -183,11 +183,32 @@ void ChatItemWidget::updateNotificationStatus()
     }
 }
 
-// 创建圆形头像
-QPixmap ChatItemWidget::createCircularPixmap(const QPixmap &srcPixmap, int diameter)
+// 有预缩放的@2x资源且当前是高分屏时使用它，否则用原路径；每个路径只查一次资源树
+QString ChatItemWidget::avatarPathForScale(const QString &path, qreal dpr)
+{
+    if (dpr <= 1.0)
+        return path;
+    static QHash<QString, QString> resolved; // 原路径 -> 高分屏下使用的路径
+    auto it = resolved.constFind(path);
+    if (it != resolved.constEnd())
+        return it.value();
+    QString result = path;
+    const int dot = path.lastIndexOf('.');
+    if (dot >= 0) {
+        const QString hiDpiPath = path.left(dot) + "@2x" + path.mid(dot);
+        if (QFile::exists(hiDpiPath))
+            result = hiDpiPath;
+    }
+    resolved.insert(path, result);
+    return result;
+}
+
+// 创建圆形头像，按设备像素比生成物理像素，显示尺寸仍为diameter
+QPixmap ChatItemWidget::createCircularPixmap(const QPixmap &srcPixmap, int logicalDiameter, qreal dpr)
 {
     if (srcPixmap.isNull())  // 如果源图像为空则返回空图像
         return QPixmap();
+    const int diameter = qRound(logicalDiameter * dpr);
 
     // 缩放图像以适应指定直径
     QPixmap scaled = srcPixmap.scaled(diameter, diameter, Qt::KeepAspectRatioByExpanding, Qt::SmoothTransformation);
@@ -210,36 +231,21 @@ QPixmap ChatItemWidget::createCircularPixmap(const QPixmap &srcPixmap, int diame
     int x = (diameter - scaled.width()) / 2;
     int y = (diameter - scaled.height()) / 2;
     painter.drawPixmap(x, y, scaled);
+    painter.end();
 
+    result.setDevicePixelRatio(dpr);
     return result;
 }
 
-// 格式化时间显示
-QString ChatItemWidget::formatTime(const QDateTime &time)
+// 跨天后刷新时间标签，只有所在分段变化时才重设文本
+void ChatItemWidget::refreshTimeLabel()
 {
-    QDate today = QDate::currentDate();  // 获取当前日期
-    QDate messageDate = time.date();  // 获取消息日期
-
-    if (messageDate == today) {  // 如果是今天
-        return time.toString("HH:mm");  // 只显示时间
-    } else if (messageDate.addDays(1) == today) {  // 如果是昨天
-        return "昨天";
-    } else if (messageDate.addDays(7) >= today) {  // 如果是一周内
-        // 返回星期几
-        QString dayOfWeek;
-        switch (messageDate.dayOfWeek()) {
-        case 1: dayOfWeek = "周一"; break;
-        case 2: dayOfWeek = "周二"; break;
-        case 3: dayOfWeek = "周三"; break;
-        case 4: dayOfWeek = "周四"; break;
-        case 5: dayOfWeek = "周五"; break;
-        case 6: dayOfWeek = "周六"; break;
-        case 7: dayOfWeek = "周日"; break;
-        }
-        return dayOfWeek;
-    } else if (messageDate.year() == today.year()) {  // 如果是今年
-        return time.toString("MM-dd");  // 显示月-日
-    } else {  // 其他情况
-        return time.toString("yyyy-MM-dd");  // 显示完整日期
-    }
+    if (!m_isFullyLoaded)
+        return;
+    qint64 timeMs = m_data.lastMessageTime.toMSecsSinceEpoch();
+    TimeBucket bucket = TimeLabelMgr::GetInstance()->bucket(timeMs);
+    if (bucket == m_timeBucket)
+        return;
+    m_timeBucket = bucket;
+    ui->m_timeLabel->setText(TimeLabelMgr::GetInstance()->label(timeMs));
 }
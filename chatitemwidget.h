@@ -3,6 +3,7 @@
 
 #include <QWidget>
 #include "chatitemdata.h"
+#include "timelabelmgr.h"
 
 namespace Ui {
 class ChatItemWidget;
@@ -29,14 +30,22 @@ public:
     void unloadData();
     // 检查是否已完整加载
     bool isFullyLoaded() const { return m_isFullyLoaded; }
+    // 跨天后按时间分段刷新时间标签
+    void refreshTimeLabel();
+    // 主题切换后刷新颜色
+    void refreshTheme();
 
 
+protected:
+    void paintEvent(QPaintEvent *event) override;
+
 private:
     Ui::ChatItemWidget *ui;
     ChatItemData m_data; // 聊天项数据
     bool m_isSelected; // 是否选中
     bool m_isFullyLoaded; // 是否已完整加载
-    static QCache<QString, QPixmap> avatarCache; // 缓存头像
+    TimeBucket m_timeBucket; // 当前时间标签所在分段
+    static QCache<QPair<QString, qreal>, QPixmap> avatarCache; // (头像路径, 设备像素比) -> 圆形头像
 
     // 初始化UI
     void initUI();
@@ -44,10 +53,14 @@ private:
     void loadData();
     // 更新消息提示状态
     void updateNotificationStatus();
+    // 按选中状态设置文字标签的调色板
+    void applyLabelPalettes();
+    // 高分屏下优先使用的头像路径
+    static QString avatarPathForScale(const QString &path, qreal dpr);
     // 创建圆形头像
-    QPixmap createCircularPixmap(const QPixmap &srcPixmap, int diameter);
-    // 格式化时间
-    QString formatTime(const QDateTime &time);
+    QPixmap createCircularPixmap(const QPixmap &srcPixmap, int logicalDiameter, qreal dpr);
+
+    static const int AVATAR_SIZE = 40; // 头像显示边长，与tools/avatarscaler的--size一致
 };
 
 #endif // CHATITEMWIDGET_H
@@ -1,24 +1,75 @@
 #include "chatlistwid.h"
 #include "chatitemwidget.h"
+#include "textlayoutcache.h"
+#include "timelabelmgr.h"
+#include "searchmgr.h"
+#include "localdb.h"
+#include "unreadmgr.h"
+#include "startuptracer.h"
+#include "thememgr.h"
 #include "qevent.h"
 
 #include <QScrollBar>
-#include <QRandomGenerator>
 #include <algorithm>
-#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QSignalBlocker>
 #include <QDebug>
 
 // 构造函数，初始化聊天列表控件
 ChatListWid::ChatListWid(QWidget *parent)
-    : QListWidget(parent), m_isFastScrolling(false), m_loadRate(100), m_timerInterval(10)
+    : QListWidget(parent), m_poolHits(0), m_poolMisses(0),
+    m_frameBudget(DEFAULT_FRAME_BUDGET), m_timerInterval(16),
+    m_firstVisible(-1), m_lastVisible(-1), m_windowFirst(-1), m_windowLast(-1),
+    m_lastScrollValue(0), m_scrollVelocity(0.0), m_cancelledLoads(0),
+    m_visibleCheckCount(0), m_visibleChecksPerSecond(0), m_selectionChanges(0), m_selectionNs(0),
+    m_flushCount(0), m_flushedItems(0), m_flushNs(0),
+    m_selectedChatId(-1), m_firstPaintLogged(false),
+    m_batchDepth(0)
 {
     initUI();
+    // 空闲加载队列，每帧只花固定的时间预算
+    m_velocityClock.start();
     m_loadTimer = new QTimer(this);
     m_loadTimer->setSingleShot(true);
-    m_loadTimer->setInterval(m_timerInterval); // 延长定时器间隔
-    connect(m_loadTimer, &QTimer::timeout, this, &ChatListWid::checkVisibleItems);
+    m_loadTimer->setInterval(m_timerInterval);
+    connect(m_loadTimer, &QTimer::timeout, this, &ChatListWid::processLoadQueue);
+    // 可见性检查次数统计
+    m_statsTimer = new QTimer(this);
+    m_statsTimer->setInterval(1000);
+    connect(m_statsTimer, &QTimer::timeout, this, &ChatListWid::reportVisibleChecks);
+    // 批量更新按帧合并
+    m_batchTimer = new QTimer(this);
+    m_batchTimer->setSingleShot(true);
+    m_batchTimer->setInterval(BATCH_FRAME_INTERVAL);
+    connect(m_batchTimer, &QTimer::timeout, this, &ChatListWid::onBatchTimeout);
     connect(this, &QListWidget::currentItemChanged, this, &ChatListWid::onCurrentItemChanged);
-    loadChatItems(createTestData());
+    // 跨天时只需检查已绑定的控件，其余行绑定时自然会取到新标签
+    connect(TimeLabelMgr::GetInstance().get(), &TimeLabelMgr::sig_day_changed, this, [this]() {
+        for (ChatItemWidget *widget : std::as_const(m_boundWidgets)) {
+            widget->refreshTimeLabel();
+        }
+    });
+    // 切换主题时已绑定和池中的控件都要换文字颜色，池中控件下次绑定时直接可用
+    connect(ThemeMgr::GetInstance().get(), &ThemeMgr::sig_theme_changed, this, [this]() {
+        for (ChatItemWidget *widget : std::as_const(m_boundWidgets)) {
+            widget->refreshTheme();
+        }
+        for (ChatItemWidget *widget : std::as_const(m_widgetPool)) {
+            widget->refreshTheme();
+        }
+    });
+    // 从本地库恢复，首次启动为空列表，等会话同步填充。
+    // 从没同步过（没有游标）却有会话，是旧版本首次启动写入的测试数据，清掉
+    StartupTracer::GetInstance()->begin("读取本地会话");
+    QVector<ChatItemData> items = LocalDb::GetInstance()->loadConversations();
+    if (!items.isEmpty() && LocalDb::GetInstance()->metaValue("chat_sync_cursor").isEmpty()) {
+        qDebug() << "清除未经同步的本地会话:" << items.size() << "项";
+        LocalDb::GetInstance()->clearConversations();
+        items.clear();
+    }
+    StartupTracer::GetInstance()->end("读取本地会话");
+    TracePhase phase("填充会话列表");
+    loadChatItems(items);
 }
 
 // 析构函数
@@ -26,10 +77,10 @@ ChatListWid::~ChatListWid()
 {
 }
 
-// 设置加载速率
-void ChatListWid::setLoadRate(int itemsPerSecond)
+// 设置每帧加载时间预算
+void ChatListWid::setFrameBudget(int milliseconds)
 {
-    m_loadRate = qMax(1, itemsPerSecond);
+    m_frameBudget = qMax(1, milliseconds);
 }
 
 // 设置定时器间隔
@@ -42,125 +93,254 @@ void ChatListWid::setTimerInterval(int milliseconds)
 // 加载聊天项列表
 void ChatListWid::loadChatItems(const QVector<ChatItemData> &items)
 {
+    releaseAllWidgets();
     clear();
-    m_chatItems.clear();
-    m_loadedItems.clear();
-    m_chatItems = items;
+    m_store.clear();
+    m_order.clear();
+    m_loadQueue.clear();
+
+    m_store.reserve(items.size());
+    m_order.reserve(items.size());
+    for (const ChatItemData &item : items) {
+        if (item.isValid)
+            m_order.append(m_store.insert(item));
+    }
     sortChatItems();
 
+    // 整体重建搜索索引
+    QVector<SearchDoc> docs;
+    docs.reserve(m_order.size());
+    for (int slot : std::as_const(m_order)) {
+        docs.append(searchDocAt(slot));
+    }
+    SearchMgr::GetInstance()->rebuild(docs);
+
     // 只创建QListWidgetItem，不立即创建ChatItemWidget
-    for (const ChatItemData &item : m_chatItems) {
-        if (item.isValid) {
-            QListWidgetItem *listItem = new QListWidgetItem(this);
-            listItem->setSizeHint(QSize(240, ITEM_HEIGHT));
-            addItem(listItem);
-        }
+    for (int i = 0; i < m_order.size(); ++i) {
+        QListWidgetItem *listItem = new QListWidgetItem(this);
+        listItem->setSizeHint(QSize(240, ITEM_HEIGHT));
     }
 
-    // 初始加载前15项
-    checkVisibleItems();
+    publishUnreadTotals();
+    // 初始加载可见项
+    invalidateVisibleRange();
 }
 
-// 创建ChatItemWidget
+// 为指定行绑定控件：优先从回收池取，池空时才新建
 void ChatListWid::createChatItemWidget(int index)
 {
-    QListWidgetItem *item = this->item(index);
-    if (!item || itemWidget(item)) // 已存在控件
+    if (index < 0 || index >= count() || m_boundWidgets.contains(index)) // 已存在控件
         return;
 
-    ChatItemWidget *widget = new ChatItemWidget(m_chatItems[index], this);
-    setItemWidget(item, widget);
+    ChatItemWidget *widget;
+    if (!m_widgetPool.isEmpty()) {
+        widget = m_widgetPool.takeLast();
+        widget->updateData(chatItemAt(index).toData());
+        ++m_poolHits;
+    } else {
+        // 控件直接挂在viewport上，由列表自己摆放，避免setItemWidget替换时删除控件
+        widget = new ChatItemWidget(chatItemAt(index).toData(), viewport());
+        widget->setAttribute(Qt::WA_TransparentForMouseEvents);
+        ++m_poolMisses;
+    }
+    m_boundWidgets.insert(index, widget);
+    widget->setGeometry(rowRect(index));
+    widget->setSelected(index == currentRow());
+    widget->show();
     widget->loadFullData();
-    m_loadedItems.insert(index);
 }
 
-// 检查并加载可见项
+// 解绑指定行的控件并放回回收池，池已满时才销毁
+void ChatListWid::releaseChatItemWidget(int index)
+{
+    ChatItemWidget *widget = m_boundWidgets.take(index);
+    if (!widget)
+        return;
+    widget->hide();
+    if (m_widgetPool.size() + m_boundWidgets.size() < poolCapacity()) {
+        m_widgetPool.append(widget);
+    } else {
+        delete widget;
+    }
+}
+
+// 解绑所有控件
+void ChatListWid::releaseAllWidgets()
+{
+    const QList<int> rows = m_boundWidgets.keys();
+    for (int i : rows) {
+        releaseChatItemWidget(i);
+    }
+}
+
+// 回收池容量：视口可容纳的行数加上预加载和预取余量
+int ChatListWid::poolCapacity() const
+{
+    return viewport()->height() / ITEM_HEIGHT + 3 + MAX_PREFETCH_ROWS;
+}
+
+// 行在视口中的位置，行高固定，直接按滚动值计算
+QRect ChatListWid::rowRect(int index) const
+{
+    return QRect(0, index * ITEM_HEIGHT - verticalScrollBar()->value(), viewport()->width(), ITEM_HEIGHT);
+}
+
+// 按当前滚动位置摆放所有已绑定的控件
+void ChatListWid::layoutBoundWidgets()
+{
+    for (auto it = m_boundWidgets.cbegin(); it != m_boundWidgets.cend(); ++it) {
+        it.value()->setGeometry(rowRect(it.key()));
+    }
+}
+
+// 检查可见范围：只在滚动值或视口尺寸真正变化时调用，范围不变直接返回
 void ChatListWid::checkVisibleItems()
 {
-    QRect viewportRect = viewport()->rect();
+    ++m_visibleCheckCount;
+    if (!m_statsTimer->isActive()) {
+        m_statsTimer->start();
+    }
+
     int scrollValue = verticalScrollBar()->value();
-    int startIndex = scrollValue / ITEM_HEIGHT;
-    int endIndex = (scrollValue + viewportRect.height()) / ITEM_HEIGHT + 1;
-    endIndex = qMin(endIndex, count() - 1);
-    startIndex = qMax(0, startIndex - 1); // 预加载上一项
-
-    // 根据加载速率计算最大加载数量
-    int maxLoad = m_isFastScrolling ? MAX_LOAD_PER_CHECK_FAST : qMin(MAX_LOAD_PER_CHECK, m_loadRate * m_timerInterval / 1000);
-    int loadedCount = 0;
-    QSet<int> currentLoadedItems;
-
-    // 加载可见项
-    for (int i = startIndex; i <= endIndex && i < count(); ++i) {
-        QListWidgetItem *item = this->item(i);
-        if (!item)
-            continue;
+    int startIndex = qMax(0, scrollValue / ITEM_HEIGHT - 1); // 预加载上一项
+    int endIndex = qMin((scrollValue + viewport()->height()) / ITEM_HEIGHT + 1, count() - 1);
 
-        // 创建控件（如果尚未创建）
-        if (!itemWidget(item)) {
-            if (loadedCount < maxLoad) {
-                createChatItemWidget(i);
-                currentLoadedItems.insert(i);
-                ++loadedCount;
-            }
-            continue;
-        }
+    // 沿滚动方向扩展预取窗口
+    int prefetch = prefetchRows();
+    int windowFirst = prefetch < 0 ? qMax(0, startIndex + prefetch) : startIndex;
+    int windowLast = prefetch > 0 ? qMin(count() - 1, endIndex + prefetch) : endIndex;
 
-        ChatItemWidget *widget = qobject_cast<ChatItemWidget*>(itemWidget(item));
-        if (!widget)
-            continue;
+    if (startIndex == m_firstVisible && endIndex == m_lastVisible
+        && windowFirst == m_windowFirst && windowLast == m_windowLast)
+        return;
+    m_firstVisible = startIndex;
+    m_lastVisible = endIndex;
+    m_windowFirst = windowFirst;
+    m_windowLast = windowLast;
+
+    // 离开窗口的控件放回回收池
+    const QList<int> boundRows = m_boundWidgets.keys();
+    for (int i : boundRows) {
+        if (i < windowFirst || i > windowLast)
+            releaseChatItemWidget(i);
+    }
+    layoutBoundWidgets();
 
-        // 加载或卸载数据
-        QRect itemRect = visualItemRect(item);
-        bool isVisible = viewportRect.intersects(itemRect.adjusted(0, -ITEM_HEIGHT, 0, ITEM_HEIGHT));
-        if (isVisible) {
-            if (!widget->isFullyLoaded() && loadedCount < maxLoad) {
-                widget->loadFullData();
-                currentLoadedItems.insert(i);
-                ++loadedCount;
-            } else if (widget->isFullyLoaded()) {
-                currentLoadedItems.insert(i);
-            }
-        } else {
-            if (widget->isFullyLoaded()) {
-                widget->unloadData();
-                // 销毁不可见控件
-                setItemWidget(item, nullptr);
-                delete widget;
-            }
+    // 重建队列：先按滚动方向加载可见项，再由近及远加载预取项
+    // 已经滚过的行不会再进入队列，相当于取消了它们的加载
+    auto needsLoad = [this](int i) {
+        ChatItemWidget *widget = m_boundWidgets.value(i);
+        return !widget || !widget->isFullyLoaded();
+    };
+    int previousQueued = m_loadQueue.size();
+    m_loadQueue.clear();
+    if (prefetch >= 0) {
+        for (int i = startIndex; i <= windowLast; ++i) {
+            if (needsLoad(i))
+                m_loadQueue.append(i);
+        }
+    } else {
+        for (int i = endIndex; i >= windowFirst; --i) {
+            if (needsLoad(i))
+                m_loadQueue.append(i);
         }
     }
+    m_cancelledLoads += qMax(0, previousQueued - m_loadQueue.size());
 
-    // 清理其他已加载但不可见的项
-    for (int i : m_loadedItems) {
-        if (!currentLoadedItems.contains(i) && i >= 0 && i < count()) {
-            QListWidgetItem *item = this->item(i);
-            if (item) {
-                ChatItemWidget *widget = qobject_cast<ChatItemWidget*>(itemWidget(item));
-                if (widget) {
-                    widget->unloadData();
-                    setItemWidget(item, nullptr);
-                    delete widget;
-                }
-            }
+    if (!m_loadQueue.isEmpty() && !m_loadTimer->isActive()) {
+        m_loadTimer->start();
+    }
+}
+
+// 预取行数：动画运行时终点已知，直接预取到终点；否则按当前速度外推
+int ChatListWid::prefetchRows() const
+{
+    double distance = m_scrollVelocity * PREFETCH_LOOKAHEAD;
+    if (m_scrollAnimation->state() == QPropertyAnimation::Running) {
+        distance = m_scrollAnimation->endValue().toInt() - verticalScrollBar()->value();
+    }
+    int rows = static_cast<int>(distance / ITEM_HEIGHT);
+    return qBound(-MAX_PREFETCH_ROWS, rows, MAX_PREFETCH_ROWS);
+}
+
+// 使缓存的可见范围失效并重新检查（数据或行发生变化后调用）
+void ChatListWid::invalidateVisibleRange()
+{
+    m_firstVisible = -1;
+    m_lastVisible = -1;
+    m_windowFirst = -1;
+    m_windowLast = -1;
+    checkVisibleItems();
+}
+
+// 空闲队列：每帧最多花m_frameBudget毫秒创建或填充控件，剩余的留到下一帧
+void ChatListWid::processLoadQueue()
+{
+    QElapsedTimer budget;
+    budget.start();
+    const qint64 budgetNs = qint64(m_frameBudget) * 1000000;
+
+    while (!m_loadQueue.isEmpty() && budget.nsecsElapsed() < budgetNs) {
+        int i = m_loadQueue.takeFirst();
+        if (i < m_windowFirst || i > m_windowLast) { // 已滚出窗口
+            ++m_cancelledLoads;
+            continue;
+        }
+        ChatItemWidget *widget = m_boundWidgets.value(i);
+        if (!widget) {
+            createChatItemWidget(i);
+        } else if (!widget->isFullyLoaded()) {
+            widget->loadFullData();
         }
     }
 
-    m_loadedItems = currentLoadedItems;
-    m_isFastScrolling = false;
+    if (!m_loadQueue.isEmpty()) {
+        m_loadTimer->start();
+    }
+}
 
-    // 强制处理事件，促进内存回收
-    QCoreApplication::processEvents();
+// 每秒输出一次可见性检查次数，空闲时降为0后停止统计
+void ChatListWid::reportVisibleChecks()
+{
+    m_visibleChecksPerSecond = m_visibleCheckCount;
+    m_visibleCheckCount = 0;
+    qDebug() << "可见性检查:" << m_visibleChecksPerSecond << "次/秒, 取消加载:" << m_cancelledLoads
+             << ", 控件池命中/未命中:" << m_poolHits << "/" << m_poolMisses
+             << ", 文本缓存命中/未命中:" << TextLayoutCache::GetInstance()->hits()
+             << "/" << TextLayoutCache::GetInstance()->misses();
+    m_cancelledLoads = 0;
+    if (m_selectionChanges > 0) {
+        qDebug() << "选中切换:" << m_selectionChanges << "次/秒, 平均"
+                 << m_selectionNs / m_selectionChanges / 1000 << "微秒/次";
+    }
+    if (m_flushCount > 0) {
+        qDebug() << "批量更新:" << m_flushCount << "次/秒, 共" << m_flushedItems << "项, 平均"
+                 << m_flushNs / m_flushCount / 1000 << "微秒/次";
+    }
+    if (m_visibleChecksPerSecond == 0 && m_selectionChanges == 0 && m_flushCount == 0) {
+        m_statsTimer->stop();
+    }
+    m_selectionChanges = 0;
+    m_selectionNs = 0;
+    m_flushCount = 0;
+    m_flushedItems = 0;
+    m_flushNs = 0;
 }
 
-// 视口事件处理
+// 视口事件处理：只关心尺寸变化，绘制事件不再触发检查
 bool ChatListWid::viewportEvent(QEvent *event)
 {
-    if (event->type() == QEvent::Paint || event->type() == QEvent::Resize) {
-        if (!m_loadTimer->isActive()) {
-            m_loadTimer->start();
-        }
+    bool result = QListWidget::viewportEvent(event);
+    if (event->type() == QEvent::Resize) {
+        invalidateVisibleRange();
+    } else if (event->type() == QEvent::Paint && !m_firstPaintLogged) {
+        m_firstPaintLogged = true;
+        qDebug() << "会话列表首次绘制: 距启动" << app_start_timer.elapsed() << "ms," << count() << "项";
+        if (login_timer.isValid())
+            qDebug() << "登录到会话列表首帧:" << login_timer.elapsed() << "ms";
+        StartupTracer::GetInstance()->markFirstFrame("会话列表首帧");
     }
-    return QListWidget::viewportEvent(event);
+    return result;
 }
 
 // 滚轮事件处理
@@ -189,70 +369,106 @@ void ChatListWid::wheelEvent(QWheelEvent *event)
     m_scrollAnimation->setStartValue(scrollBar->value());
     m_scrollAnimation->setEndValue(m_targetScrollValue);
     m_scrollAnimation->start();
-
-    m_isFastScrolling = true;
-    if (!m_loadTimer->isActive()) {
-        m_loadTimer->start();
-    }
     event->accept();
 }
 
-// 滚动条值改变处理
+// 滚动条值改变处理（动画的每一帧也会走到这里）
 void ChatListWid::onScrollBarValueChanged(int value)
 {
-    if (m_scrollAnimation->state() == QPropertyAnimation::Running) {
-        return;
+    if (m_scrollAnimation->state() != QPropertyAnimation::Running) {
+        m_targetScrollValue = value;
     }
-    m_targetScrollValue = value;
-    m_isFastScrolling = true;
-    if (!m_loadTimer->isActive()) {
-        m_loadTimer->start();
+
+    // 估算滚动速度，长时间未滚动则视为从静止开始
+    qint64 elapsed = m_velocityClock.restart();
+    if (elapsed > 0 && elapsed < 100) {
+        double instant = double(value - m_lastScrollValue) / elapsed;
+        m_scrollVelocity = m_scrollVelocity * 0.6 + instant * 0.4;
+    } else {
+        m_scrollVelocity = 0.0;
     }
-    viewport()->update();
+    m_lastScrollValue = value;
+
+    checkVisibleItems();
 }
 
 // 当前项改变处理
 void ChatListWid::onCurrentItemChanged(QListWidgetItem *current, QListWidgetItem *previous)
 {
+    QElapsedTimer timer;
+    timer.start();
+
     if (previous) {
-        ChatItemWidget *prevWidget = qobject_cast<ChatItemWidget*>(itemWidget(previous));
+        ChatItemWidget *prevWidget = m_boundWidgets.value(row(previous));
         if (prevWidget) {
             prevWidget->setSelected(false);
         }
     }
 
     if (current) {
-        if (!itemWidget(current)) {
-            createChatItemWidget(row(current));
+        int currentIndex = row(current);
+        if (!m_boundWidgets.contains(currentIndex)) {
+            createChatItemWidget(currentIndex);
         }
-        ChatItemWidget *currWidget = qobject_cast<ChatItemWidget*>(itemWidget(current));
+        ChatItemWidget *currWidget = m_boundWidgets.value(currentIndex);
         if (currWidget) {
             currWidget->setSelected(true);
             if (!currWidget->isFullyLoaded()) {
                 currWidget->loadFullData();
-                m_loadedItems.insert(row(current));
             }
         }
     }
+
+    // 统计选中切换次数和耗时（按住方向键时可观察每秒切换数）
+    ++m_selectionChanges;
+    m_selectionNs += timer.nsecsElapsed();
+    if (!m_statsTimer->isActive()) {
+        m_statsTimer->start();
+    }
+
+    // 只有会话真正变化时才通知（重排后恢复选中不算）
+    ChatItemRef ref = current ? chatItemAt(row(current)) : ChatItemRef();
+    int chatId = ref.isNull() ? -1 : ref.id();
+    if (chatId != m_selectedChatId) {
+        m_selectedChatId = chatId;
+        if (chatId != -1)
+            emit sig_chat_selected(chatId);
+    }
 }
 
 // 按最后消息时间排序聊天项
 void ChatListWid::sortChatItems()
 {
-    std::sort(m_chatItems.begin(), m_chatItems.end(),
-              [](const ChatItemData &a, const ChatItemData &b) {
-                  return a.lastMessageTime > b.lastMessageTime;
+    std::sort(m_order.begin(), m_order.end(),
+              [this](int a, int b) {
+                  return m_store.timeMsAt(a) > m_store.timeMsAt(b);
               });
 }
 
 // 查找新项的插入位置
 int ChatListWid::findInsertPosition(const ChatItemData &data) const
 {
-    auto it = std::lower_bound(m_chatItems.begin(), m_chatItems.end(), data,
-                               [](const ChatItemData &a, const ChatItemData &b) {
-                                   return a.lastMessageTime > b.lastMessageTime;
+    const qint64 timeMs = data.lastMessageTime.toMSecsSinceEpoch();
+    auto it = std::lower_bound(m_order.begin(), m_order.end(), timeMs,
+                               [this](int slot, qint64 value) {
+                                   return m_store.timeMsAt(slot) > value;
+                               });
+    return std::distance(m_order.begin(), it);
+}
+
+// 槽位在显示顺序中的行号：按时间二分，同一时间的几行再逐个比对
+int ChatListWid::findOrderIndex(int slot) const
+{
+    const qint64 timeMs = m_store.timeMsAt(slot);
+    auto it = std::lower_bound(m_order.begin(), m_order.end(), timeMs,
+                               [this](int other, qint64 value) {
+                                   return m_store.timeMsAt(other) > value;
                                });
-    return std::distance(m_chatItems.begin(), it);
+    for (; it != m_order.end() && m_store.timeMsAt(*it) == timeMs; ++it) {
+        if (*it == slot)
+            return std::distance(m_order.begin(), it);
+    }
+    return m_order.indexOf(slot);
 }
 
 // 添加聊天项
@@ -261,18 +477,31 @@ void ChatListWid::addChatItem(const ChatItemData &data)
     if (!data.isValid)
         return;
 
+    // 已存在的会话按更新处理
+    int existingSlot = m_store.slotOf(data.id);
+    if (existingSlot >= 0) {
+        updateChatItem(m_order.indexOf(existingSlot), data);
+        return;
+    }
+
     int insertIndex = findInsertPosition(data);
-    m_chatItems.insert(insertIndex, data);
+    int slot = m_store.insert(data);
+    m_order.insert(insertIndex, slot);
+    SearchMgr::GetInstance()->upsert(searchDocAt(slot));
+    LocalDb::GetInstance()->enqueueConversation(data);
+    publishUnreadTotals();
 
     QListWidgetItem *item = new QListWidgetItem;
     item->setSizeHint(QSize(240, ITEM_HEIGHT));
     insertItem(insertIndex, item);
 
-    QRect viewportRect = viewport()->rect();
-    QRect itemRect = visualItemRect(item);
-    if (viewportRect.intersects(itemRect)) {
-        createChatItemWidget(insertIndex);
+    // 插入点之后的已绑定控件行号后移
+    QHash<int, ChatItemWidget*> shifted;
+    for (auto it = m_boundWidgets.cbegin(); it != m_boundWidgets.cend(); ++it) {
+        shifted.insert(it.key() >= insertIndex ? it.key() + 1 : it.key(), it.value());
     }
+    m_boundWidgets = shifted;
+    invalidateVisibleRange();
 }
 
 // 更新聊天项
@@ -281,19 +510,24 @@ void ChatListWid::updateChatItem(int index, const ChatItemData &data)
     if (index < 0 || index >= count())
         return;
 
-    if (index < m_chatItems.size() && m_chatItems[index].lastMessageTime == data.lastMessageTime) {
-        m_chatItems[index] = data;
-        QListWidgetItem *item = this->item(index);
-        if (item) {
-            ChatItemWidget *widget = qobject_cast<ChatItemWidget*>(itemWidget(item));
-            if (widget) {
-                widget->updateData(data);
-                widget->setSelected(currentRow() == index);
-                if (m_loadedItems.contains(index) && !widget->isFullyLoaded()) {
-                    widget->loadFullData();
-                }
-            } else if (m_loadedItems.contains(index)) {
-                createChatItemWidget(index);
+    // 批量事务中只排队，由flush统一应用
+    if (m_batchDepth > 0) {
+        postChatItemUpdate(data);
+        return;
+    }
+
+    if (index < m_order.size()
+        && m_store.timeMsAt(m_order[index]) == data.lastMessageTime.toMSecsSinceEpoch()) {
+        m_store.update(m_order[index], data);
+        SearchMgr::GetInstance()->upsert(searchDocAt(m_order[index]));
+        LocalDb::GetInstance()->enqueueConversation(data);
+        publishUnreadTotals();
+        ChatItemWidget *widget = m_boundWidgets.value(index);
+        if (widget) {
+            widget->updateData(chatItemAt(index).toData());
+            widget->setSelected(currentRow() == index);
+            if (!widget->isFullyLoaded()) {
+                widget->loadFullData();
             }
         }
         return;
@@ -303,30 +537,275 @@ void ChatListWid::updateChatItem(int index, const ChatItemData &data)
     addChatItem(data);
 }
 
+// 开始批量更新
+void ChatListWid::beginUpdateBatch()
+{
+    ++m_batchDepth;
+}
+
+// 结束批量更新，最外层结束时安排到下一帧统一应用
+void ChatListWid::endUpdateBatch()
+{
+    if (m_batchDepth <= 0)
+        return;
+    if (--m_batchDepth == 0 && !m_pendingUpdates.isEmpty() && !m_batchTimer->isActive()) {
+        m_batchTimer->start();
+    }
+}
+
+// 投递会话更新，同一会话的多次更新只保留最后一次
+void ChatListWid::postChatItemUpdate(const ChatItemData &data)
+{
+    m_pendingUpdates.insert(data.id, data);
+    if (m_batchDepth == 0 && !m_batchTimer->isActive()) {
+        m_batchTimer->start();
+    }
+}
+
+// 帧定时器到期
+void ChatListWid::onBatchTimeout()
+{
+    if (m_batchDepth > 0) // 事务尚未结束，等endUpdateBatch
+        return;
+    flushChatItemUpdates();
+}
+
+// 统一应用所有待处理更新：一次遍历、一次重排、一次重绘
+void ChatListWid::flushChatItemUpdates()
+{
+    m_batchTimer->stop();
+    if (m_pendingUpdates.isEmpty())
+        return;
+
+    QElapsedTimer timer;
+    timer.start();
+    const int pendingCount = m_pendingUpdates.size();
+
+    // 记录当前选中的会话，排序后按id恢复
+    int selectedId = -1;
+    int current = currentRow();
+    if (current >= 0 && current < m_order.size())
+        selectedId = m_store.idAt(m_order[current]);
+
+    // 批量相对总行数较小时只把变化的行移出再按时间二分插回，否则整体重排
+    const bool incremental = pendingCount * FULL_SORT_RATIO < m_order.size();
+    if (incremental) {
+        for (const ChatItemData &data : std::as_const(m_pendingUpdates)) {
+            int slot = m_store.slotOf(data.id);
+            int index = slot >= 0 ? findOrderIndex(slot) : -1;
+            if (index >= 0)
+                m_order.remove(index);
+        }
+    }
+
+    // 按id直接定位槽位：更新、新增或删除
+    for (const ChatItemData &data : std::as_const(m_pendingUpdates)) {
+        int slot = m_store.slotOf(data.id);
+        if (!data.isValid) {
+            m_store.remove(slot);
+            SearchMgr::GetInstance()->remove(data.id);
+            LocalDb::GetInstance()->enqueueConversation(data);
+            continue;
+        }
+        if (slot >= 0) {
+            m_store.update(slot, data);
+        } else {
+            slot = m_store.insert(data);
+        }
+        SearchMgr::GetInstance()->upsert(searchDocAt(slot));
+        LocalDb::GetInstance()->enqueueConversation(data);
+        if (incremental)
+            m_order.insert(findInsertPosition(data), slot);
+    }
+    m_pendingUpdates.clear();
+    publishUnreadTotals();
+    if (!incremental) {
+        m_order = m_store.validSlots();
+        sortChatItems();
+    }
+
+    setUpdatesEnabled(false);
+    {
+        // 行只是占位，增删尾部行即可与数据对齐，避免逐行发出选中信号
+        QSignalBlocker blocker(this);
+        while (count() > m_order.size()) {
+            delete takeItem(count() - 1);
+        }
+        while (count() < m_order.size()) {
+            QListWidgetItem *listItem = new QListWidgetItem(this);
+            listItem->setSizeHint(QSize(240, ITEM_HEIGHT));
+        }
+
+        const int selectedSlot = selectedId != -1 ? m_store.slotOf(selectedId) : -1;
+        setCurrentRow(selectedSlot >= 0 ? findOrderIndex(selectedSlot) : -1);
+    }
+    rebindLoadedWidgets();
+    setUpdatesEnabled(true);
+    viewport()->update();
+    invalidateVisibleRange();
+
+    // 持续推送时每帧都会刷新，只累计次数和耗时，由每秒统计统一输出
+    ++m_flushCount;
+    m_flushedItems += pendingCount;
+    m_flushNs += timer.nsecsElapsed();
+    if (!m_statsTimer->isActive()) {
+        m_statsTimer->start();
+    }
+}
+
+// 应用同步增量，立即刷新，保证会话写入先于游标进入写后队列
+void ChatListWid::applyChatListDelta(const ChatListDelta &delta)
+{
+    beginUpdateBatch();
+    for (const ChatItemData &data : delta.upserts) {
+        postChatItemUpdate(data);
+    }
+    for (int id : delta.removes) {
+        ChatItemData removed(id);
+        removed.isValid = false;
+        postChatItemUpdate(removed);
+    }
+    for (const QPair<int, int> &change : delta.unreadChanges) {
+        // 同一批里已有该会话的更新时在其上修改，否则从存储取当前数据
+        auto pending = m_pendingUpdates.find(change.first);
+        if (pending != m_pendingUpdates.end()) {
+            pending->unreadCount = change.second;
+            continue;
+        }
+        int slot = m_store.slotOf(change.first);
+        if (slot < 0)
+            continue;
+        ChatItemData data = m_store.row(slot).toData();
+        data.unreadCount = change.second;
+        postChatItemUpdate(data);
+    }
+    endUpdateBatch();
+    flushChatItemUpdates();
+    qDebug() << "同步增量: 新增/修改" << delta.upserts.size() << ", 删除" << delta.removes.size()
+             << ", 未读变化" << delta.unreadChanges.size();
+}
+
+// 高频推送下同一会话在一帧内的多条消息合并成一次更新
+void ChatListWid::applyIncomingMessage(const MessageData &message)
+{
+    ChatItemData data;
+    auto pending = m_pendingUpdates.constFind(message.chatId);
+    if (pending != m_pendingUpdates.constEnd()) {
+        if (!pending->isValid)
+            return;
+        data = pending.value();
+    } else {
+        int slot = m_store.slotOf(message.chatId);
+        if (slot < 0) // 会话还没同步下来，之后的增量同步会带上最新预览
+            return;
+        data = m_store.row(slot).toData();
+    }
+    data.lastMessage = message.text;
+    data.lastMessageTime = QDateTime::fromMSecsSinceEpoch(message.timeMs);
+    if (!message.outgoing && message.chatId != m_selectedChatId)
+        ++data.unreadCount;
+    postChatItemUpdate(data);
+}
+
+// 全部标为已读：存储里一次遍历清零，数据库一条语句，只重绑可见控件
+void ChatListWid::markAllRead()
+{
+    QElapsedTimer timer;
+    timer.start();
+    // 先应用排队中的更新，避免之后覆盖清零结果
+    flushChatItemUpdates();
+    int cleared = m_store.clearUnread();
+    if (cleared == 0)
+        return;
+    LocalDb::GetInstance()->clearAllUnread();
+    publishUnreadTotals();
+    rebindLoadedWidgets();
+    qDebug() << "全部已读:" << cleared << "个会话, 耗时" << timer.elapsed() << "ms";
+}
+
+// 把存储维护的未读汇总交给UnreadMgr，由它按帧合并发布
+void ChatListWid::publishUnreadTotals()
+{
+    UnreadMgr::GetInstance()->setTotals(m_store.unreadTotals());
+}
+
+// 重新绑定已创建控件的数据
+void ChatListWid::rebindLoadedWidgets()
+{
+    int current = currentRow();
+    const QList<int> rows = m_boundWidgets.keys();
+    for (int i : rows) {
+        if (i < 0 || i >= count()) {
+            releaseChatItemWidget(i);
+            continue;
+        }
+        ChatItemWidget *widget = m_boundWidgets.value(i);
+        widget->updateData(chatItemAt(i).toData());
+        widget->setSelected(i == current);
+        if (!widget->isFullyLoaded()) {
+            widget->loadFullData();
+        }
+    }
+}
+
 // 移除聊天项
 void ChatListWid::removeChatItem(int index)
 {
     if (index < 0 || index >= count())
         return;
-    if (index < m_chatItems.size())
-        m_chatItems.removeAt(index);
-    m_loadedItems.remove(index);
+    if (index < m_order.size()) {
+        int slot = m_order.takeAt(index);
+        SearchMgr::GetInstance()->remove(m_store.idAt(slot));
+        ChatItemData removed = m_store.row(slot).toData();
+        removed.isValid = false;
+        LocalDb::GetInstance()->enqueueConversation(removed);
+        m_store.remove(slot);
+        publishUnreadTotals();
+    }
+    releaseChatItemWidget(index);
     QListWidgetItem *item = takeItem(index);
     delete item;
+
+    // 删除点之后的已绑定控件行号前移
+    QHash<int, ChatItemWidget*> shifted;
+    for (auto it = m_boundWidgets.cbegin(); it != m_boundWidgets.cend(); ++it) {
+        shifted.insert(it.key() > index ? it.key() - 1 : it.key(), it.value());
+    }
+    m_boundWidgets = shifted;
+    invalidateVisibleRange();
 }
 
-// 获取所有聊天项数据
-QVector<ChatItemData> ChatListWid::getChatItems() const
+// 获取指定行的会话视图
+ChatItemRef ChatListWid::chatItemAt(int index) const
 {
-    return m_chatItems;
+    if (index < 0 || index >= m_order.size())
+        return ChatItemRef();
+    return m_store.row(m_order[index]);
 }
 
 // 获取指定索引的聊天项数据
 ChatItemData ChatListWid::getChatItemData(int index) const
 {
-    if (index < 0 || index >= m_chatItems.size())
+    if (index < 0 || index >= m_order.size())
         return ChatItemData();
-    return m_chatItems[index];
+    return chatItemAt(index).toData();
+}
+
+// 按会话id选中并滚动到该行
+bool ChatListWid::selectChat(int id)
+{
+    int row = m_order.indexOf(m_store.slotOf(id));
+    if (row < 0)
+        return false;
+    setCurrentRow(row);
+    scrollToItem(item(row), QAbstractItemView::PositionAtCenter);
+    return true;
+}
+
+// 槽位对应的搜索文档
+SearchDoc ChatListWid::searchDocAt(int slot) const
+{
+    return SearchDoc{m_store.idAt(slot), m_store.nameAt(slot), m_store.previewAt(slot), m_store.timeMsAt(slot)};
 }
 
 // 获取当前选中项的索引
@@ -367,155 +846,8 @@ void ChatListWid::initUI()
     m_scrollAnimation->setDuration(300);
     m_scrollAnimation->setEasingCurve(QEasingCurve::OutCubic);
 
-    setStyleSheet(
-        "QListWidget {"
-        "   background-color: white;"
-        "   border: none;"
-        "   outline: none;"
-        "}"
-        "QListWidget::item {"
-        "   background-color: white;"
-        "   border-radius: 4px;"
-        "   margin: 2px 5px;"
-        "}"
-        "QListWidget::item:selected {"
-        "   background-color: #A2A2FE;"
-        "}"
-        "QListWidget::item:hover:!selected {"
-        "   background-color: #F0F0F0;"
-        "}"
-        "QScrollBar:vertical {"
-        "   background: transparent;"
-        "   width: 4px;"
-        "   margin: 0px 0px 0px 0px;"
-        "   border-radius: 4px;"
-        "}"
-        "QScrollBar:vertical:hover, QListWidget:hover QScrollBar:vertical {"
-        "   background: #F5F5F5;"
-        "}"
-        "QScrollBar::handle:vertical {"
-        "   background: #C0C0C0;"
-        "   min-height: 20px;"
-        "   border-radius: 4px;"
-        "}"
-        "QScrollBar::handle:vertical:hover {"
-        "   background: #A0A0A0;"
-        "}"
-        "QScrollBar::add-line:vertical, QScrollBar::sub-line:vertical {"
-        "   height: 0px;"
-        "   background: none;"
-        "}"
-        "QScrollBar::add-page:vertical, QScrollBar::sub-page:vertical {"
-        "   background: none;"
-        "}"
-        );
-}
-
-// 创建测试数据
-QVector<ChatItemData> ChatListWid::createTestData()
-{
-    // 配置变量 - 只需修改这些变量即可调整数据模拟量
-    const int TOTAL_COUNT = 10000;          // 总数据量
-    const int INDIVIDUAL_RATIO = 60;        // 个人聊天占比（百分比）
-    const int GROUP_RATIO = 40;             // 群聊占比（百分比）
-    const int MAX_UNREAD_INDIVIDUAL = 20;    // 个人聊天最大未读数
-    const int MAX_UNREAD_GROUP = 150;        // 群聊最大未读数
-    const int MUTE_PROB_INDIVIDUAL = 10;     // 个人聊天静音概率（百分比）
-    const int MUTE_PROB_GROUP = 30;          // 群聊静音概率（百分比）
-    const int UNREAD_PROB_INDIVIDUAL = 30;   // 个人聊天有未读消息概率（百分比）
-    const int UNREAD_PROB_GROUP = 60;        // 群聊有未读消息概率（百分比）
-    const int SENDER_PROB = 50;              // 显示发送者概率（百分比）
-
-    QVector<ChatItemData> testData;
-    testData.reserve(TOTAL_COUNT);
-
-    // 静态数据配置
-    QStringList avatarPaths = {
-        ":/LogReg/avatars/avatar1.png",
-        ":/LogReg/avatars/avatar2.png",
-        ":/LogReg/avatars/avatar3.png",
-        ":/LogReg/avatars/avatar4.png",
-        ":/LogReg/avatars/avatar5.png",
-        ":/LogReg/avatars/avatar6.png",
-    };
-
-    QStringList surnames = {"赵","钱","孙","李","周","吴","郑","王","冯","陈","褚","卫","蒋","沈","韩","杨"};
-    QStringList givenNames = {"伟","芳","娜","秀英","敏","静","丽","强","磊","军","洋","勇","艳","杰","娟","涛"};
-    QStringList groupSuffixes = {"交流群","讨论组","粉丝群","亲友团","同学会","工作群","项目组","游戏群"};
-
-    QStringList messageTemplates = {
-        "你吃饭了吗？",
-        "在吗？有事找你",
-        "[图片]",
-        "[语音消息]",
-        "明天下午3点开会",
-        "这个需求什么时候能完成？",
-        "我马上到",
-        "周末一起出去玩吧",
-        "你看这个链接：https://example.com",
-        "😂😂😂",
-        "好的，没问题",
-        "我再考虑一下",
-        "谢谢！",
-        "你听说了吗？",
-        "最新版本已经发布",
-        "帮我带杯咖啡",
-        "晚上吃什么？",
-        "项目进度怎么样了？",
-        "这个bug怎么解决？",
-        "记得带身份证"
-    };
-
-    // 预生成名称列表
-    QStringList names;
-    int individualCount = TOTAL_COUNT * INDIVIDUAL_RATIO / 100;
-    int groupCount = TOTAL_COUNT * GROUP_RATIO / 100;
-
-    for (int i = 0; i < individualCount; ++i) {
-        names.append(surnames[QRandomGenerator::global()->bounded(surnames.size())] +
-                     givenNames[QRandomGenerator::global()->bounded(givenNames.size())]);
-    }
-
-    for (int i = 0; i < groupCount; ++i) {
-        QString name = surnames[QRandomGenerator::global()->bounded(surnames.size())] +
-                       givenNames[QRandomGenerator::global()->bounded(givenNames.size())] +
-                       "的" + groupSuffixes[QRandomGenerator::global()->bounded(groupSuffixes.size())];
-        names.append(name);
-    }
-
-    // 生成测试数据
-    QDateTime now = QDateTime::currentDateTime();
-    for (int i = 0; i < TOTAL_COUNT; ++i) {
-        ChatItemData item;
-        item.id = i + 1;
-        item.avatarPath = avatarPaths[i % avatarPaths.size()];
-        int randomMinutes = QRandomGenerator::global()->bounded(43200); // 30天内随机时间
-        item.lastMessageTime = now.addSecs(-randomMinutes * 60);
-        item.name = names[i];
-
-        bool isGroup = item.name.contains("群");
-
-        // 生成最后一条消息
-        if (QRandomGenerator::global()->bounded(100) < SENDER_PROB && !isGroup) {
-            QString sender = names[QRandomGenerator::global()->bounded(individualCount)] + ": ";
-            item.lastMessage = sender + messageTemplates[QRandomGenerator::global()->bounded(messageTemplates.size())];
-        } else {
-            item.lastMessage = messageTemplates[QRandomGenerator::global()->bounded(messageTemplates.size())];
-        }
-
-        // 生成未读消息数
-        if (QRandomGenerator::global()->bounded(100) < (isGroup ? UNREAD_PROB_GROUP : UNREAD_PROB_INDIVIDUAL)) {
-            item.unreadCount = QRandomGenerator::global()->bounded(1, isGroup ? MAX_UNREAD_GROUP : MAX_UNREAD_INDIVIDUAL);
-        } else {
-            item.unreadCount = 0;
-        }
-
-        // 设置静音状态
-        item.muted = QRandomGenerator::global()->bounded(100) < (isGroup ? MUTE_PROB_GROUP : MUTE_PROB_INDIVIDUAL);
-        item.isValid = true;
-        testData.append(item);
-    }
-
-    std::shuffle(testData.begin(), testData.end(), *QRandomGenerator::global());
-    return testData;
+    // 背景、选中和悬停效果、细滚动条由BaijiuStyle按属性绘制
+    setProperty("themeRole", "chatList");
+    if (scrollBar)
+        scrollBar->setProperty("thinScrollBar", true);
 }
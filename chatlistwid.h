@@ -4,11 +4,19 @@
 #include <QListWidget>
 #include <QPropertyAnimation>
 #include <QTimer>
+#include <QHash>
+#include <QElapsedTimer>
 #include "chatitemdata.h"
+#include "messagedata.h"
+#include "chatitemstore.h"
+#include "chatsearchindex.h"
+
+class ChatItemWidget;
 
 class ChatListWid : public QListWidget
 {
     Q_OBJECT
+    friend class tst_ChatListBench; // 压测需要单独计时排序、读取行序
 public:
     explicit ChatListWid(QWidget *parent = nullptr);
     ~ChatListWid();
@@ -21,16 +29,42 @@ public:
     void addChatItem(const ChatItemData &data);
     // 移除会话项
     void removeChatItem(int index);
-    // 获取会话项数据
-    QVector<ChatItemData> getChatItems() const;
+    // 获取会话存储（只读）
+    const ChatItemStore &chatItemStore() const { return m_store; }
+    // 获取指定行的会话视图
+    ChatItemRef chatItemAt(int index) const;
     // 获取单个会话项数据
     ChatItemData getChatItemData(int index) const;
+    // 按会话id选中并滚动到该行，不存在返回false
+    bool selectChat(int id);
     // 返回当前选中的会话项索引
     int currentChatIndex() const;
-    // 设置加载速率（项/秒）
-    void setLoadRate(int itemsPerSecond);
+    // 设置每帧用于创建/填充控件的时间预算（毫秒）
+    void setFrameBudget(int milliseconds);
     // 设置定时器间隔（毫秒）
     void setTimerInterval(int milliseconds);
+    // 上一秒的可见性检查次数
+    int visibleChecksPerSecond() const { return m_visibleChecksPerSecond; }
+    // 控件回收池命中/未命中次数
+    int poolHits() const { return m_poolHits; }
+    int poolMisses() const { return m_poolMisses; }
+
+    // 批量更新：begin/end之间投递的更新只在end时统一应用
+    void beginUpdateBatch();
+    void endUpdateBatch();
+    // 投递一条会话更新（按id合并，isValid为false表示移除），下一帧统一应用
+    void postChatItemUpdate(const ChatItemData &data);
+    // 立即应用所有已投递的更新
+    void flushChatItemUpdates();
+    // 应用一页同步增量：新增/修改、删除和未读数变化在同一批中生效
+    void applyChatListDelta(const ChatListDelta &delta);
+    // 收到新消息：更新预览和时间，不是当前会话时未读数加一，随下一帧的批量更新生效
+    void applyIncomingMessage(const MessageData &message);
+    // 全部标为已读
+    void markAllRead();
+
+signals:
+    void sig_chat_selected(int id); // 选中的会话变化
 
 protected:
     void wheelEvent(QWheelEvent *event) override;
@@ -39,34 +73,86 @@ protected:
     bool viewportEvent(QEvent *event) override;
 
 private slots:
-    void checkVisibleItems(); // 检查可见项并触发懒加载
+    void checkVisibleItems(); // 检查可见范围并把待加载项放入空闲队列
+    void processLoadQueue(); // 空闲队列：每帧加载少量项
+    void reportVisibleChecks(); // 输出每秒可见性检查次数
     void onCurrentItemChanged(QListWidgetItem *current, QListWidgetItem *previous);
     void onScrollBarValueChanged(int value);
+    void onBatchTimeout(); // 每帧合并应用一次批量更新
 
 private:
     // 存储会话数据
-    QVector<ChatItemData> m_chatItems;
+    ChatItemStore m_store;
+    QVector<int> m_order; // 显示顺序：行号 -> 存储槽位
     QPropertyAnimation *m_scrollAnimation; // 滚动动画
     int m_targetScrollValue; // 目标滚动值
-    QTimer *m_loadTimer; // 延迟加载定时器
-    QSet<int> m_loadedItems; // 跟踪已加载的项索引
-    bool m_isFastScrolling; // 标记快速滚动状态
-    int m_loadRate; // 加载速率（项/秒）
+    QTimer *m_loadTimer; // 空闲加载队列定时器
+    QHash<int, ChatItemWidget*> m_boundWidgets; // 行号到已绑定控件
+    QVector<ChatItemWidget*> m_widgetPool; // 空闲控件回收池
+    int m_poolHits; // 从回收池取到控件的次数
+    int m_poolMisses; // 回收池为空而新建控件的次数
+    QList<int> m_loadQueue; // 待创建或待填充的项索引
+    int m_frameBudget; // 每帧加载时间预算（毫秒）
     int m_timerInterval; // 定时器间隔（毫秒）
+    int m_firstVisible; // 上次计算的可见范围起点（含预加载）
+    int m_lastVisible; // 上次计算的可见范围终点（含预加载）
+    int m_windowFirst; // 可见范围加滚动方向预取后的起点
+    int m_windowLast; // 可见范围加滚动方向预取后的终点
+    int m_lastScrollValue; // 上次滚动值，用于估算速度
+    double m_scrollVelocity; // 平滑后的滚动速度（像素/毫秒，正数向下）
+    QElapsedTimer m_velocityClock; // 滚动速度计时
+    int m_cancelledLoads; // 统计窗口内被取消的加载数
+    QTimer *m_statsTimer; // 检查次数统计定时器
+    int m_visibleCheckCount; // 当前统计窗口内的检查次数
+    int m_visibleChecksPerSecond; // 上一秒的检查次数
+    int m_selectionChanges; // 统计窗口内的选中切换次数
+    qint64 m_selectionNs; // 统计窗口内选中切换的总耗时（纳秒）
+    int m_flushCount; // 统计窗口内的批量更新次数
+    int m_flushedItems; // 统计窗口内批量更新的总项数
+    qint64 m_flushNs; // 统计窗口内批量更新的总耗时（纳秒）
+    int m_selectedChatId; // 上次通知的选中会话
+    bool m_firstPaintLogged; // 是否已记录首次绘制时间
     static const int ITEM_HEIGHT = 72; // 项高度
-    static const int MAX_LOAD_PER_CHECK = 10; // 每次最多加载 10 项
-    static const int MAX_LOAD_PER_CHECK_FAST = 5; // 快速滚动时降低到 5
+    static const int DEFAULT_FRAME_BUDGET = 4; // 默认每帧预算 4ms
+    static const int PREFETCH_LOOKAHEAD = 200; // 按当前速度预测未来 200ms 的滚动距离
+    static const int MAX_PREFETCH_ROWS = 30; // 单方向最多预取 30 行
+    static const int BATCH_FRAME_INTERVAL = 16; // 批量更新的帧间隔（毫秒）
+    static const int FULL_SORT_RATIO = 32; // 批量超过总行数的1/32时整体重排，否则逐行二分插回
+
+    QHash<int, ChatItemData> m_pendingUpdates; // 待应用的更新（按会话id合并）
+    QTimer *m_batchTimer; // 帧合并定时器
+    int m_batchDepth; // 批量事务嵌套深度
 
     // 初始化UI
     void initUI();
-    // 创建测试数据
-    QVector<ChatItemData> createTestData();
     // 按时间排序
     void sortChatItems();
+    // 槽位对应的搜索文档
+    SearchDoc searchDocAt(int slot) const;
+    // 发布未读汇总
+    void publishUnreadTotals();
     // 查找插入位置
     int findInsertPosition(const ChatItemData &data) const;
-    // 创建ChatItemWidget
+    // 槽位在显示顺序中的行号
+    int findOrderIndex(int slot) const;
+    // 为指定行绑定ChatItemWidget（优先复用回收池）
     void createChatItemWidget(int index);
+    // 解绑指定行的控件并放回回收池
+    void releaseChatItemWidget(int index);
+    // 解绑所有控件
+    void releaseAllWidgets();
+    // 回收池容量
+    int poolCapacity() const;
+    // 行在视口中的矩形
+    QRect rowRect(int index) const;
+    // 按滚动位置摆放已绑定控件
+    void layoutBoundWidgets();
+    // 重新绑定已创建控件的数据（排序或增删后行号会变化）
+    void rebindLoadedWidgets();
+    // 使可见范围失效并重新检查
+    void invalidateVisibleRange();
+    // 根据滚动速度和动画终点计算预取行数（带符号，正数向下）
+    int prefetchRows() const;
 };
 
 #endif // CHATLISTWID_H
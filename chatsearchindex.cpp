@@ -0,0 +1,258 @@
+#include "chatsearchindex.h"
+#include "pinyintable.h"
+#include <algorithm>
+
+void ChatSearchIndex::clear()
+{
+    m_docs.clear();
+    m_postings.clear();
+}
+
+void ChatSearchIndex::build(const QVector<SearchDoc> &docs)
+{
+    clear();
+    m_docs.reserve(docs.size());
+    // 重名很多，同名只转换一次拼音
+    QHash<QString, QStringList> pinyinByName;
+    // 先按键收集，最后统一排序，避免逐条有序插入
+    for (const SearchDoc &doc : docs) {
+        auto cached = pinyinByName.constFind(doc.name);
+        if (cached == pinyinByName.constEnd())
+            cached = pinyinByName.insert(doc.name, PinyinTable::keys(doc.name));
+        Entry entry = makeEntry(doc, cached.value());
+        const QVector<quint32> grams = entryGrams(entry);
+        for (quint32 gram : grams) {
+            m_postings[gram].append(doc.id);
+        }
+        m_docs.insert(doc.id, entry);
+    }
+    for (auto it = m_postings.begin(); it != m_postings.end(); ++it) {
+        QVector<int> &ids = it.value();
+        std::sort(ids.begin(), ids.end());
+        ids.erase(std::unique(ids.begin(), ids.end()), ids.end());
+    }
+}
+
+void ChatSearchIndex::upsert(const SearchDoc &doc)
+{
+    auto it = m_docs.find(doc.id);
+    if (it != m_docs.end()) {
+        // 文本没变只更新时间
+        if (it->name == doc.name.toCaseFolded() && it->preview == doc.preview.toCaseFolded()) {
+            it->timeMs = doc.timeMs;
+            return;
+        }
+        removePostings(doc.id, it.value());
+    }
+    Entry entry = makeEntry(doc, PinyinTable::keys(doc.name));
+    addPostings(doc.id, entry);
+    m_docs.insert(doc.id, entry);
+}
+
+void ChatSearchIndex::remove(int id)
+{
+    auto it = m_docs.find(id);
+    if (it == m_docs.end())
+        return;
+    removePostings(id, it.value());
+    m_docs.erase(it);
+}
+
+QVector<SearchHit> ChatSearchIndex::search(const QString &query, int limit) const
+{
+    QVector<SearchHit> result;
+    search(query, limit,
+           [&result](const QVector<SearchHit> &hits, bool finished) {
+               if (finished)
+                   result = hits;
+           },
+           []() { return false; });
+    return result;
+}
+
+void ChatSearchIndex::search(const QString &query, int limit, const ProgressFn &progress,
+                             const CancelFn &cancelled) const
+{
+    QVector<SearchHit> hits;
+    const QString folded = query.trimmed().toCaseFolded();
+    if (folded.isEmpty() || limit <= 0) {
+        progress(hits, true);
+        return;
+    }
+
+    // 取出所有倒排表，任一键不存在则无结果
+    QVector<const QVector<int>*> lists;
+    const QVector<quint32> grams = queryGrams(folded);
+    for (quint32 gram : grams) {
+        auto it = m_postings.constFind(gram);
+        if (it == m_postings.constEnd()) {
+            progress(hits, true);
+            return;
+        }
+        lists.append(&it.value());
+    }
+    std::sort(lists.begin(), lists.end(),
+              [](const QVector<int> *a, const QVector<int> *b) { return a->size() < b->size(); });
+
+    auto better = [](const SearchHit &a, const SearchHit &b) {
+        if (a.rank != b.rank)
+            return a.rank < b.rank;
+        return a.timeMs > b.timeMs;
+    };
+    // 只保留前limit条，块与块之间合并
+    auto keepTop = [&]() {
+        if (hits.size() > limit) {
+            std::partial_sort(hits.begin(), hits.begin() + limit, hits.end(), better);
+            hits.resize(limit);
+        } else {
+            std::sort(hits.begin(), hits.end(), better);
+        }
+    };
+
+    // 从最短的倒排表出发，在其余表中二分确认
+    const QVector<int> &shortest = *lists.first();
+    for (int begin = 0; begin < shortest.size(); begin += SEARCH_CHUNK) {
+        if (cancelled())
+            return;
+        const int end = qMin<int>(begin + SEARCH_CHUNK, shortest.size());
+        bool changed = false;
+        for (int i = begin; i < end; ++i) {
+            const int id = shortest[i];
+            bool inAll = true;
+            for (int j = 1; j < lists.size() && inAll; ++j) {
+                inAll = std::binary_search(lists[j]->begin(), lists[j]->end(), id);
+            }
+            if (!inAll)
+                continue;
+
+            // 双字键只保证字对出现过，最后做一次子串校验并分级
+            const Entry &entry = *m_docs.constFind(id);
+            int rank = nameRank(entry.name, folded);
+            for (const QString &key : entry.pinyin) {
+                int keyRank = nameRank(key, folded);
+                if (keyRank >= 0 && (rank < 0 || keyRank < rank))
+                    rank = keyRank;
+            }
+            if (rank < 0 && entry.preview.contains(folded))
+                rank = RANK_PREVIEW;
+            if (rank < 0)
+                continue;
+            hits.append(SearchHit{id, rank, entry.timeMs});
+            changed = true;
+        }
+        if (end == shortest.size())
+            break;
+        if (changed) {
+            keepTop();
+            progress(hits, false);
+        }
+    }
+    keepTop();
+    progress(hits, true);
+}
+
+qint64 ChatSearchIndex::memoryBytes() const
+{
+    qint64 bytes = m_docs.capacity() * qint64(sizeof(int) + sizeof(Entry) + sizeof(void*));
+    for (const Entry &entry : m_docs) {
+        bytes += (entry.name.capacity() + entry.preview.capacity()) * qint64(sizeof(QChar)) + 2 * 24;
+        for (const QString &key : entry.pinyin) {
+            bytes += key.capacity() * qint64(sizeof(QChar)) + 24 + qint64(sizeof(QString));
+        }
+    }
+    bytes += m_postings.capacity() * qint64(sizeof(quint32) + sizeof(QVector<int>) + sizeof(void*));
+    for (const QVector<int> &ids : m_postings) {
+        bytes += ids.capacity() * qint64(sizeof(int)) + 24;
+    }
+    return bytes;
+}
+
+int ChatSearchIndex::pinyinKeyCount() const
+{
+    int total = 0;
+    for (const Entry &entry : m_docs) {
+        total += entry.pinyin.size();
+    }
+    return total;
+}
+
+ChatSearchIndex::Entry ChatSearchIndex::makeEntry(const SearchDoc &doc, const QStringList &pinyin)
+{
+    return Entry{doc.name.toCaseFolded(), doc.preview.toCaseFolded(), doc.timeMs, pinyin};
+}
+
+int ChatSearchIndex::nameRank(const QString &text, const QString &folded)
+{
+    if (text == folded)
+        return RANK_EXACT;
+    if (text.startsWith(folded))
+        return RANK_PREFIX;
+    if (text.contains(folded))
+        return RANK_NAME;
+    return -1;
+}
+
+QVector<quint32> ChatSearchIndex::gramsOf(const QString &folded)
+{
+    QVector<quint32> grams;
+    grams.reserve(folded.size() * 2);
+    for (int i = 0; i < folded.size(); ++i) {
+        grams.append(gramKey(folded[i]));
+        if (i + 1 < folded.size())
+            grams.append(gramKey(folded[i], folded[i + 1]));
+    }
+    return grams;
+}
+
+QVector<quint32> ChatSearchIndex::entryGrams(const Entry &entry)
+{
+    QVector<quint32> grams = gramsOf(entry.name) + gramsOf(entry.preview);
+    for (const QString &key : entry.pinyin) {
+        grams += gramsOf(key);
+    }
+    std::sort(grams.begin(), grams.end());
+    grams.erase(std::unique(grams.begin(), grams.end()), grams.end());
+    return grams;
+}
+
+QVector<quint32> ChatSearchIndex::queryGrams(const QString &folded)
+{
+    QVector<quint32> grams;
+    if (folded.size() == 1) {
+        grams.append(gramKey(folded[0]));
+        return grams;
+    }
+    for (int i = 0; i + 1 < folded.size(); ++i) {
+        grams.append(gramKey(folded[i], folded[i + 1]));
+    }
+    std::sort(grams.begin(), grams.end());
+    grams.erase(std::unique(grams.begin(), grams.end()), grams.end());
+    return grams;
+}
+
+void ChatSearchIndex::addPostings(int id, const Entry &entry)
+{
+    const QVector<quint32> grams = entryGrams(entry);
+    for (quint32 gram : grams) {
+        QVector<int> &ids = m_postings[gram];
+        auto pos = std::lower_bound(ids.begin(), ids.end(), id);
+        if (pos == ids.end() || *pos != id)
+            ids.insert(pos, id);
+    }
+}
+
+void ChatSearchIndex::removePostings(int id, const Entry &entry)
+{
+    const QVector<quint32> grams = entryGrams(entry);
+    for (quint32 gram : grams) {
+        auto it = m_postings.find(gram);
+        if (it == m_postings.end())
+            continue;
+        QVector<int> &ids = it.value();
+        auto pos = std::lower_bound(ids.begin(), ids.end(), id);
+        if (pos != ids.end() && *pos == id)
+            ids.erase(pos);
+        if (ids.isEmpty())
+            m_postings.erase(it);
+    }
+}
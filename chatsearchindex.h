@@ -0,0 +1,93 @@
+#ifndef CHATSEARCHINDEX_H
+#define CHATSEARCHINDEX_H
+
+#include <QString>
+#include <QVector>
+#include <QHash>
+#include <QStringList>
+#include <QMetaType>
+#include <functional>
+
+// 被索引的会话文本
+struct SearchDoc {
+    int id;             // 会话ID
+    QString name;       // 用户名或群名
+    QString preview;    // 最后一条消息预览
+    qint64 timeMs;      // 最后消息时间，用于同级排序
+};
+
+// 匹配等级，数值越小越靠前
+enum SearchRank {
+    RANK_EXACT = 0,     // 名称完全匹配
+    RANK_PREFIX = 1,    // 名称前缀匹配
+    RANK_NAME = 2,      // 名称包含
+    RANK_PREVIEW = 3    // 消息预览包含
+};
+
+// 搜索结果
+struct SearchHit {
+    int id;
+    int rank;
+    qint64 timeMs;
+};
+Q_DECLARE_METATYPE(SearchHit)
+
+/**
+ * @brief 会话搜索索引
+ * 对名称和预览建立单字与双字的倒排表，查询时取最短的倒排表求交集，
+ * 再对候选做一次子串校验并分级；增删改只触及该会话自己的倒排项。
+ * 名称的拼音全拼和首字母在建索引时生成，与名称一起进入倒排表，查询时不做转换。
+ */
+class ChatSearchIndex
+{
+public:
+    void clear();
+    // 批量重建
+    void build(const QVector<SearchDoc> &docs);
+    // 新增或更新
+    void upsert(const SearchDoc &doc);
+    // 删除
+    void remove(int id);
+    // 查询，按等级和时间排序后最多返回limit条
+    QVector<SearchHit> search(const QString &query, int limit) const;
+    // 分块查询：每校验完一块候选，若结果有变化就回调当前的前limit条，最后一次回调finished为true；
+    // 每块之前检查cancelled，返回true时直接放弃（过期的查询不再回调）
+    using ProgressFn = std::function<void(const QVector<SearchHit> &hits, bool finished)>;
+    using CancelFn = std::function<bool()>;
+    void search(const QString &query, int limit, const ProgressFn &progress, const CancelFn &cancelled) const;
+
+    static const int SEARCH_CHUNK = 2048; // 每块校验的候选数
+    int size() const { return m_docs.size(); }
+    // 估算占用的字节数
+    qint64 memoryBytes() const;
+    // 拼音检索键总数
+    int pinyinKeyCount() const;
+
+private:
+    struct Entry {
+        QString name;       // 折叠大小写后的名称
+        QString preview;    // 折叠大小写后的预览
+        qint64 timeMs;
+        QStringList pinyin; // 名称的拼音全拼和首字母
+    };
+
+    static Entry makeEntry(const SearchDoc &doc, const QStringList &pinyin);
+    // 名称或拼音键的匹配等级，不匹配返回-1
+    static int nameRank(const QString &text, const QString &folded);
+
+    // 文本中出现的所有单字和双字键（去重）
+    static QVector<quint32> gramsOf(const QString &folded);
+    static QVector<quint32> entryGrams(const Entry &entry);
+    // 查询串对应的键：单字查询用单字键，否则用双字键
+    static QVector<quint32> queryGrams(const QString &folded);
+    static quint32 gramKey(QChar first, QChar second) { return (quint32(first.unicode()) << 16) | second.unicode(); }
+    static quint32 gramKey(QChar single) { return single.unicode(); }
+
+    void addPostings(int id, const Entry &entry);
+    void removePostings(int id, const Entry &entry);
+
+    QHash<int, Entry> m_docs;
+    QHash<quint32, QVector<int>> m_postings; // 键 -> 有序的会话ID
+};
+
+#endif // CHATSEARCHINDEX_H
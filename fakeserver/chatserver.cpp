@@ -0,0 +1,381 @@
+#include "chatserver.h"
+#include "linkshaper.h"
+#include <QDataStream>
+#include <QJsonDocument>
+#include <QJsonArray>
+#include <QDateTime>
+#include <QRandomGenerator>
+#include <QDebug>
+#include <algorithm>
+
+namespace {
+
+const QStringList SURNAMES = {"赵","钱","孙","李","周","吴","郑","王","冯","陈","褚","卫","蒋","沈","韩","杨"};
+const QStringList GIVEN_NAMES = {"伟","芳","娜","秀英","敏","静","丽","强","磊","军","洋","勇","艳","杰","娟","涛"};
+const QStringList MESSAGES = {
+    "你吃饭了吗？", "在吗？有事找你", "[图片]", "[语音消息]", "明天下午3点开会",
+    "我马上到", "好的，没问题", "谢谢！", "最新版本已经发布", "晚上吃什么？"
+};
+const QStringList AVATARS = {
+    ":/LogReg/avatars/avatar1.png", ":/LogReg/avatars/avatar2.png", ":/LogReg/avatars/avatar3.png",
+    ":/LogReg/avatars/avatar4.png", ":/LogReg/avatars/avatar5.png", ":/LogReg/avatars/avatar6.png",
+};
+
+int jsonSize(const QJsonValue &value)
+{
+    if (value.isObject())
+        return QJsonDocument(value.toObject()).toJson(QJsonDocument::Compact).size();
+    if (value.isArray())
+        return QJsonDocument(value.toArray()).toJson(QJsonDocument::Compact).size();
+    return QByteArray::number(value.toInteger()).size();
+}
+
+} // namespace
+
+ChatServer::ChatServer(int conversationCount, int mutationsPerSecond, int messagesPerSecond,
+                       LinkShaper *shaper, QObject *parent)
+    : QObject(parent), _shaper(shaper), _seq(0), _mutationsPerTick(0), _bytesSent(0),
+      _messagesPerSecond(messagesPerSecond), _pushedTotal(0), _pushedReported(0), _lastReportMs(0),
+      _received(0), _duplicates(0)
+{
+    _conversations.reserve(conversationCount);
+    for (int i = 1; i <= conversationCount; ++i) {
+        _conversations.append(makeConversation(i));
+    }
+    connect(&_server, &QTcpServer::newConnection, this, &ChatServer::onNewConnection);
+
+    _mutationsPerTick = mutationsPerSecond * MUTATION_INTERVAL / 1000;
+    if (mutationsPerSecond > 0) {
+        _mutationsPerTick = qMax(1, _mutationsPerTick);
+        _mutationTimer.setInterval(MUTATION_INTERVAL);
+        connect(&_mutationTimer, &QTimer::timeout, this, &ChatServer::onMutationTick);
+        _mutationTimer.start();
+    }
+
+    if (messagesPerSecond > 0) {
+        _pushTimer.setInterval(PUSH_INTERVAL);
+        _pushTimer.setTimerType(Qt::PreciseTimer);
+        connect(&_pushTimer, &QTimer::timeout, this, &ChatServer::onPushTick);
+        _pushTimer.start();
+        _pushClock.start();
+    }
+}
+
+bool ChatServer::listen(quint16 port)
+{
+    if (!_server.listen(QHostAddress::Any, port)) {
+        qDebug() << "监听失败:" << _server.errorString();
+        return false;
+    }
+    qDebug() << "聊天服务器监听端口" << port << ", 会话" << _conversations.size() << "个";
+    return true;
+}
+
+ServerConversation ChatServer::makeConversation(int id)
+{
+    QRandomGenerator *gen = QRandomGenerator::global();
+    ServerConversation conversation;
+    conversation.id = id;
+    conversation.name = SURNAMES[gen->bounded(SURNAMES.size())] + GIVEN_NAMES[gen->bounded(GIVEN_NAMES.size())];
+    conversation.avatar = AVATARS[id % AVATARS.size()];
+    conversation.preview = MESSAGES[gen->bounded(MESSAGES.size())];
+    conversation.timeMs = QDateTime::currentMSecsSinceEpoch() - qint64(gen->bounded(43200)) * 60 * 1000;
+    conversation.unread = gen->bounded(100) < 30 ? gen->bounded(1, 20) : 0;
+    conversation.muted = gen->bounded(100) < 10;
+    conversation.removed = false;
+    conversation.contentVersion = ++_seq;
+    conversation.unreadVersion = 0;
+    return conversation;
+}
+
+void ChatServer::onNewConnection()
+{
+    while (QTcpSocket *socket = _server.nextPendingConnection()) {
+        _buffers.insert(socket, QByteArray());
+        connect(socket, &QTcpSocket::readyRead, this, &ChatServer::onReadyRead);
+        connect(socket, &QTcpSocket::disconnected, this, &ChatServer::onDisconnected);
+        qDebug() << "客户端连接:" << socket->peerAddress().toString() << socket->peerPort();
+    }
+}
+
+void ChatServer::onDisconnected()
+{
+    QTcpSocket *socket = qobject_cast<QTcpSocket*>(sender());
+    _buffers.remove(socket);
+    _sessions.remove(socket);
+    _ackDue.remove(socket);
+    _shaper->forget(socket);
+    socket->deleteLater();
+    qDebug() << "客户端断开, 累计发送" << _bytesSent << "字节";
+}
+
+// 与客户端TcpMgr相同的分帧：2字节ID + 2字节长度 + 消息体
+void ChatServer::onReadyRead()
+{
+    QTcpSocket *socket = qobject_cast<QTcpSocket*>(sender());
+    QByteArray &buffer = _buffers[socket];
+    buffer.append(socket->readAll());
+
+    while (buffer.size() >= HEADER_SIZE) {
+        QDataStream stream(buffer);
+        quint16 id = 0;
+        quint16 len = 0;
+        stream >> id >> len;
+        if (buffer.size() < HEADER_SIZE + len)
+            break;
+        QByteArray body = buffer.mid(HEADER_SIZE, len);
+        buffer.remove(0, HEADER_SIZE + len);
+        handleMessage(socket, id, body);
+    }
+    // 一批数据里的多条消息只回一个累计确认
+    if (_ackDue.remove(socket))
+        sendAck(socket);
+}
+
+void ChatServer::handleMessage(QTcpSocket *socket, quint16 id, const QByteArray &body)
+{
+    QJsonDocument doc = QJsonDocument::fromJson(body);
+    if (!doc.isObject()) {
+        qDebug() << "请求JSON解析失败, ID:" << id;
+        return;
+    }
+    switch (id) {
+    case ID_CHAT_LOGIN:
+        handleLogin(socket, doc.object());
+        break;
+    case ID_SYNC_CHAT_LIST:
+        handleSync(socket, doc.object());
+        break;
+    case ID_SEND_CHAT_MSG:
+        handleSendMessage(socket, doc.object());
+        break;
+    default:
+        qDebug() << "未处理的消息ID:" << id;
+        break;
+    }
+}
+
+void ChatServer::handleLogin(QTcpSocket *socket, const QJsonObject &request)
+{
+    QJsonObject response;
+    response["error"] = 0;
+    response["uid"] = request["uid"].toInt();
+    response["token"] = request["token"].toString();
+    response["name"] = QString("用户%1").arg(request["uid"].toInt());
+    send(socket, ID_CHAT_LOGIN_RSP, response);
+    _sessions.insert(socket, request["uid"].toInt());
+}
+
+// 下发游标之后的变化，按序号从小到大，单页放不下时设置more，客户端带新游标继续请求
+void ChatServer::handleSync(QTcpSocket *socket, const QJsonObject &request)
+{
+    const qint64 cursor = request["cursor"].toInteger();
+
+    // 游标之后有变化的会话，按最近一次变化的序号排序
+    QVector<const ServerConversation*> changed;
+    for (const ServerConversation &conversation : std::as_const(_conversations)) {
+        if (conversation.contentVersion > cursor || conversation.unreadVersion > cursor)
+            changed.append(&conversation);
+    }
+    auto lastVersion = [](const ServerConversation *c) { return qMax(c->contentVersion, c->unreadVersion); };
+    std::sort(changed.begin(), changed.end(),
+              [&](const ServerConversation *a, const ServerConversation *b) { return lastVersion(a) < lastVersion(b); });
+
+    QJsonArray upserts;
+    QJsonArray removes;
+    QJsonArray unread;
+    int pageBytes = 0;
+    qint64 pageCursor = _seq;
+    bool more = false;
+    for (const ServerConversation *conversation : std::as_const(changed)) {
+        QJsonValue entry;
+        if (conversation->contentVersion > cursor) {
+            entry = conversation->removed ? QJsonValue(conversation->id) : QJsonValue(conversationJson(*conversation));
+        } else {
+            entry = QJsonArray{conversation->id, conversation->unread};
+        }
+        const int entryBytes = jsonSize(entry) + 1;
+        if (pageBytes + entryBytes > MAX_PAGE_BYTES) {
+            // 游标停在上一条，剩余的下一页再发
+            more = true;
+            break;
+        }
+        pageBytes += entryBytes;
+        pageCursor = lastVersion(conversation);
+
+        if (conversation->contentVersion > cursor && conversation->removed)
+            removes.append(entry);
+        else if (conversation->contentVersion > cursor)
+            upserts.append(entry);
+        else
+            unread.append(entry);
+    }
+
+    QJsonObject response;
+    response["error"] = 0;
+    response["cursor"] = more ? pageCursor : _seq;
+    response["more"] = more;
+    response["upserts"] = upserts;
+    response["removes"] = removes;
+    response["unread"] = unread;
+    send(socket, ID_SYNC_CHAT_LIST_RSP, response);
+    qDebug() << "同步: 游标" << cursor << "->" << response["cursor"].toInteger() << ", 新增/修改" << upserts.size()
+             << ", 删除" << removes.size() << ", 未读" << unread.size() << (more ? ", 还有下一页" : "");
+}
+
+QJsonObject ChatServer::conversationJson(const ServerConversation &conversation) const
+{
+    QJsonObject item;
+    item["id"] = conversation.id;
+    item["n"] = conversation.name;
+    item["a"] = conversation.avatar;
+    item["p"] = conversation.preview;
+    item["t"] = conversation.timeMs;
+    item["u"] = conversation.unread;
+    item["m"] = conversation.muted;
+    return item;
+}
+
+void ChatServer::send(QTcpSocket *socket, quint16 id, const QJsonObject &body)
+{
+    QByteArray payload = QJsonDocument(body).toJson(QJsonDocument::Compact);
+    if (payload.size() > MAX_BODY_SIZE) {
+        qDebug() << "消息体过长, 丢弃:" << payload.size();
+        return;
+    }
+    QByteArray frame;
+    QDataStream stream(&frame, QIODevice::WriteOnly);
+    stream << id << static_cast<quint16>(payload.size());
+    frame.append(payload);
+    _shaper->write(socket, frame);
+    _bytesSent += frame.size();
+}
+
+void ChatServer::onMutationTick()
+{
+    for (int i = 0; i < _mutationsPerTick; ++i) {
+        mutateOne();
+    }
+}
+
+// 随机变化一条会话：新消息、已读、删除或新增
+void ChatServer::mutateOne()
+{
+    QRandomGenerator *gen = QRandomGenerator::global();
+    int roll = gen->bounded(100);
+    if (roll < 5) {
+        _conversations.append(makeConversation(_conversations.size() + 1));
+        return;
+    }
+
+    ServerConversation &conversation = _conversations[gen->bounded(_conversations.size())];
+    if (conversation.removed)
+        return;
+    if (roll < 75) {
+        conversation.preview = MESSAGES[gen->bounded(MESSAGES.size())];
+        conversation.timeMs = QDateTime::currentMSecsSinceEpoch();
+        ++conversation.unread;
+        conversation.contentVersion = ++_seq;
+    } else if (roll < 95) {
+        conversation.unread = 0;
+        conversation.unreadVersion = ++_seq;
+    } else {
+        conversation.removed = true;
+        conversation.contentVersion = ++_seq;
+    }
+}
+
+// 按流逝时间补足应推送的条数，定时器抖动或事件循环卡顿都不会让速率偏低
+void ChatServer::onPushTick()
+{
+    const qint64 elapsed = _pushClock.elapsed();
+    const qint64 due = elapsed * _messagesPerSecond / 1000;
+    while (_pushedTotal < due) {
+        pushOne();
+    }
+    if (elapsed - _lastReportMs >= 1000) {
+        if (!_sessions.isEmpty()) {
+            qDebug() << "推送:" << (_pushedTotal - _pushedReported) * 1000 / (elapsed - _lastReportMs)
+                     << "条/秒," << _sessions.size() << "个连接, 累计发送" << _bytesSent << "字节";
+        }
+        _pushedReported = _pushedTotal;
+        _lastReportMs = elapsed;
+    }
+}
+
+// 随机选一条会话产生新消息：更新会话表（之后的增量同步也能看到），并推给所有已登录的连接
+// 推送格式：{"chat":会话id, "seq":推送序号, "text":内容, "t":发送时间毫秒}
+void ChatServer::pushOne()
+{
+    ++_pushedTotal;
+    if (_sessions.isEmpty() || _conversations.isEmpty())
+        return;
+
+    QRandomGenerator *gen = QRandomGenerator::global();
+    ServerConversation &conversation = _conversations[gen->bounded(_conversations.size())];
+    if (conversation.removed)
+        return;
+    const qint64 now = QDateTime::currentMSecsSinceEpoch();
+    conversation.preview = MESSAGES[gen->bounded(MESSAGES.size())];
+    conversation.timeMs = now;
+    ++conversation.unread;
+    conversation.contentVersion = ++_seq;
+
+    QJsonObject message;
+    message["chat"] = conversation.id;
+    message["seq"] = _pushedTotal;
+    message["text"] = conversation.preview;
+    message["t"] = now;
+    for (auto it = _sessions.constBegin(); it != _sessions.constEnd(); ++it) {
+        send(it.key(), ID_NOTIFY_CHAT_MSG, message);
+    }
+}
+
+// 客户端发件箱的消息：{"id":客户端消息id, "chat":会话id, "text":内容, "t":发送时间毫秒}
+// id按用户递增，不大于已收到的最大id即为重连后的重发，只确认不再处理
+void ChatServer::handleSendMessage(QTcpSocket *socket, const QJsonObject &request)
+{
+    auto session = _sessions.constFind(socket);
+    if (session == _sessions.constEnd()) {
+        qDebug() << "未登录的连接发送消息, 丢弃";
+        return;
+    }
+    const qint64 id = request["id"].toInteger();
+    qint64 &lastId = _lastClientIds[session.value()];
+    _ackDue.insert(socket);
+    if (id <= lastId) {
+        ++_duplicates;
+        return;
+    }
+    if (id != lastId + 1)
+        qDebug() << "客户端消息id不连续:" << lastId << "->" << id;
+    lastId = id;
+    ++_received;
+
+    const int chat = request["chat"].toInt();
+    if (chat >= 1 && chat <= _conversations.size() && !_conversations[chat - 1].removed) {
+        ServerConversation &conversation = _conversations[chat - 1];
+        conversation.preview = request["text"].toString();
+        conversation.timeMs = request["t"].toInteger();
+        conversation.contentVersion = ++_seq;
+    }
+}
+
+// 累计确认：回当前用户已收到的最大id，每秒输出一次接收统计
+void ChatServer::sendAck(QTcpSocket *socket)
+{
+    QJsonObject ack;
+    ack["ack"] = _lastClientIds.value(_sessions.value(socket));
+    send(socket, ID_SEND_CHAT_MSG_ACK, ack);
+
+    if (!_receiveClock.isValid())
+        _receiveClock.start();
+    const qint64 elapsed = _receiveClock.elapsed();
+    if (elapsed < 1000)
+        return;
+    qDebug() << "收到客户端消息:" << _received * 1000 / elapsed << "条/秒, 重复" << _duplicates
+             << "条, 最大id" << ack["ack"].toInteger();
+    _received = 0;
+    _duplicates = 0;
+    _receiveClock.restart();
+}
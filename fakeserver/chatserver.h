@@ -0,0 +1,91 @@
+#ifndef CHATSERVER_H
+#define CHATSERVER_H
+
+#include <QObject>
+#include <QTcpServer>
+#include <QTcpSocket>
+#include <QHash>
+#include <QSet>
+#include <QTimer>
+#include <QElapsedTimer>
+#include <QJsonObject>
+#include "protocol.h"
+
+class LinkShaper;
+
+// 服务端的一条会话，带两个版本号：内容版本和未读数版本
+struct ServerConversation {
+    int id;
+    QString name;
+    QString avatar;
+    QString preview;
+    qint64 timeMs;
+    int unread;
+    bool muted;
+    bool removed;           // 已删除（保留墓碑以便增量下发）
+    qint64 contentVersion;  // 名称/预览/时间等变化时的序号
+    qint64 unreadVersion;   // 只有未读数变化时的序号
+};
+
+/**
+ * @brief 本地替身聊天服务器
+ * 实现与客户端相同的报文分帧，处理聊天登录和会话列表增量同步；
+ * 会话表由定时器持续随机变化，用来验证客户端的合并逻辑和同步流量；
+ * 可按固定速率向已登录的连接推送新消息，用来压测客户端的入站吞吐和延迟；
+ * 接收客户端发件箱发来的消息，按用户记录收到的最大客户端id去重，每批读到的数据回一个累计确认。
+ */
+class ChatServer : public QObject
+{
+    Q_OBJECT
+public:
+    ChatServer(int conversationCount, int mutationsPerSecond, int messagesPerSecond,
+               LinkShaper *shaper, QObject *parent = nullptr);
+
+    bool listen(quint16 port);
+
+private slots:
+    void onNewConnection();
+    void onReadyRead();
+    void onDisconnected();
+    void onMutationTick();
+    void onPushTick();
+
+private:
+    void handleMessage(QTcpSocket *socket, quint16 id, const QByteArray &body);
+    void handleLogin(QTcpSocket *socket, const QJsonObject &request);
+    void handleSync(QTcpSocket *socket, const QJsonObject &request);
+    void handleSendMessage(QTcpSocket *socket, const QJsonObject &request);
+    void sendAck(QTcpSocket *socket);
+    void send(QTcpSocket *socket, quint16 id, const QJsonObject &body);
+    QJsonObject conversationJson(const ServerConversation &conversation) const;
+    ServerConversation makeConversation(int id);
+    void mutateOne();
+    void pushOne();
+
+    QTcpServer _server;
+    QHash<QTcpSocket*, QByteArray> _buffers;  // 每个连接的接收缓冲
+    QHash<QTcpSocket*, int> _sessions;        // 已完成聊天登录的连接 -> uid，接收推送
+    QHash<int, qint64> _lastClientIds;        // 每个用户已收到的最大客户端消息id，断线重连后仍保留
+    QSet<QTcpSocket*> _ackDue;                // 本批读到了新消息、待回确认的连接
+    LinkShaper *_shaper;
+    QVector<ServerConversation> _conversations; // 下标为id-1
+    qint64 _seq;                              // 全局变更序号，即同步游标
+    QTimer _mutationTimer;
+    int _mutationsPerTick;
+    qint64 _bytesSent;
+    QTimer _pushTimer;
+    QElapsedTimer _pushClock;                 // 按实际流逝时间折算应推送的条数
+    int _messagesPerSecond;
+    qint64 _pushedTotal;                      // 已推送的消息数，即推送序号
+    qint64 _pushedReported;                   // 上次输出统计时的推送数
+    qint64 _lastReportMs;
+    qint64 _received;                         // 统计窗口内收到的客户端消息（去重后）
+    qint64 _duplicates;                       // 统计窗口内重发的重复消息
+    QElapsedTimer _receiveClock;
+
+    static const int MUTATION_INTERVAL = 100;   // 变更定时器间隔（毫秒）
+    static const int PUSH_INTERVAL = 10;        // 推送定时器间隔（毫秒）
+    static const int MAX_PAGE_BYTES = 60000;    // 单页响应的上限，留出余量给JSON外壳
+};
+
+#endif // CHATSERVER_H
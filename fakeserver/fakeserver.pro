@@ -0,0 +1,18 @@
+QT       = core network
+
+CONFIG += c++17 console
+CONFIG -= app_bundle
+
+TARGET = fakeserver
+
+SOURCES += \
+    chatserver.cpp \
+    gateserver.cpp \
+    linkshaper.cpp \
+    main.cpp
+
+HEADERS += \
+    chatserver.h \
+    gateserver.h \
+    linkshaper.h \
+    protocol.h
@@ -0,0 +1,228 @@
+#include "gateserver.h"
+#include "linkshaper.h"
+#include "protocol.h"
+#include <QJsonDocument>
+#include <QRandomGenerator>
+#include <QDebug>
+
+namespace {
+
+// 与客户端global.cpp中的xorString相同，异或两次即还原
+QString xorString(const QString &input)
+{
+    QString result = input;
+    int length = input.length() % 255;
+    for (int i = 0; i < length; ++i) {
+        result[i] = QChar(static_cast<ushort>(input[i].unicode() ^ static_cast<ushort>(length)));
+    }
+    return result;
+}
+
+QByteArray reasonPhrase(int status)
+{
+    switch (status) {
+    case 200: return "OK";
+    case 400: return "Bad Request";
+    case 404: return "Not Found";
+    default: return "Error";
+    }
+}
+
+} // namespace
+
+GateServer::GateServer(const QString &chatHost, quint16 chatPort, const QString &verifyCode,
+                       LinkShaper *shaper, QObject *parent)
+    : QObject(parent), _chatHost(chatHost), _chatPort(chatPort), _verifyCode(verifyCode),
+      _shaper(shaper), _nextUid(FIRST_UID), _requests(0)
+{
+    connect(&_server, &QTcpServer::newConnection, this, &GateServer::onNewConnection);
+}
+
+bool GateServer::listen(quint16 port)
+{
+    if (!_server.listen(QHostAddress::Any, port)) {
+        qDebug() << "网关监听失败:" << _server.errorString();
+        return false;
+    }
+    qDebug() << "网关服务器监听端口" << port << ", 聊天服务器" << _chatHost << _chatPort
+             << ", 验证码" << _verifyCode;
+    return true;
+}
+
+void GateServer::onNewConnection()
+{
+    while (QTcpSocket *socket = _server.nextPendingConnection()) {
+        _buffers.insert(socket, QByteArray());
+        connect(socket, &QTcpSocket::readyRead, this, &GateServer::onReadyRead);
+        connect(socket, &QTcpSocket::disconnected, this, &GateServer::onDisconnected);
+    }
+}
+
+void GateServer::onDisconnected()
+{
+    QTcpSocket *socket = qobject_cast<QTcpSocket*>(sender());
+    _buffers.remove(socket);
+    _shaper->forget(socket);
+    socket->deleteLater();
+}
+
+void GateServer::onReadyRead()
+{
+    QTcpSocket *socket = qobject_cast<QTcpSocket*>(sender());
+    QByteArray &buffer = _buffers[socket];
+    buffer.append(socket->readAll());
+
+    QByteArray path;
+    QByteArray body;
+    bool keepAlive = true;
+    while (takeRequest(buffer, path, body, keepAlive)) {
+        handleRequest(socket, path, body, keepAlive);
+    }
+    if (buffer.size() > MAX_HEADER_BYTES && !buffer.contains("\r\n\r\n")) {
+        qDebug() << "请求头过长, 断开连接";
+        socket->abort();
+    }
+}
+
+// 只认请求行、Content-Length和Connection，其余请求头忽略
+bool GateServer::takeRequest(QByteArray &buffer, QByteArray &path, QByteArray &body, bool &keepAlive) const
+{
+    const int headerEnd = buffer.indexOf("\r\n\r\n");
+    if (headerEnd < 0)
+        return false;
+
+    const QList<QByteArray> lines = buffer.left(headerEnd).split('\n');
+    const QList<QByteArray> requestLine = lines.first().trimmed().split(' ');
+    qsizetype contentLength = 0;
+    keepAlive = requestLine.value(2) != "HTTP/1.0";
+    for (int i = 1; i < lines.size(); ++i) {
+        const int colon = lines[i].indexOf(':');
+        if (colon < 0)
+            continue;
+        const QByteArray name = lines[i].left(colon).trimmed().toLower();
+        const QByteArray value = lines[i].mid(colon + 1).trimmed();
+        if (name == "content-length")
+            contentLength = value.toLongLong();
+        else if (name == "connection")
+            keepAlive = value.toLower() != "close";
+    }
+
+    const qsizetype bodyBegin = headerEnd + 4;
+    if (buffer.size() < bodyBegin + contentLength)
+        return false;
+    path = requestLine.value(1);
+    body = buffer.mid(bodyBegin, contentLength);
+    buffer.remove(0, bodyBegin + contentLength);
+    return true;
+}
+
+void GateServer::handleRequest(QTcpSocket *socket, const QByteArray &path, const QByteArray &body, bool keepAlive)
+{
+    ++_requests;
+    const QJsonDocument doc = QJsonDocument::fromJson(body);
+    QJsonObject response;
+    if (!doc.isObject()) {
+        response["error"] = Error_Json;
+    } else if (path == "/get_verifycode") {
+        response = handleVerifyCode(doc.object());
+    } else if (path == "/user_register") {
+        response = handleRegister(doc.object());
+    } else if (path == "/reset_pwd") {
+        response = handleReset(doc.object());
+    } else if (path == "/user_login") {
+        response = handleLogin(doc.object());
+    } else {
+        qDebug() << "网关: 未知路径" << path;
+        respond(socket, 404, QByteArray(), keepAlive);
+        return;
+    }
+    qDebug() << "网关:" << path << "error" << response["error"].toInt();
+    respond(socket, 200, QJsonDocument(response).toJson(QJsonDocument::Compact), keepAlive);
+}
+
+QJsonObject GateServer::handleVerifyCode(const QJsonObject &request)
+{
+    QJsonObject response;
+    response["error"] = SUCCESS;
+    response["email"] = request["email"].toString();
+    return response;
+}
+
+QJsonObject GateServer::handleRegister(const QJsonObject &request)
+{
+    QJsonObject response;
+    const QString email = request["email"].toString();
+    response["email"] = email;
+    if (request["verifycode"].toString() != _verifyCode) {
+        response["error"] = VerifyCodeErr;
+    } else if (request["passwd"].toString() != request["confirm"].toString()) {
+        response["error"] = PasswdErr;
+    } else if (_users.contains(email)) {
+        response["error"] = UserEmailExists;
+    } else {
+        const GateUser user = {_nextUid++, request["user"].toString(), xorString(request["passwd"].toString())};
+        _users.insert(email, user);
+        response["error"] = SUCCESS;
+        response["uid"] = user.uid;
+    }
+    return response;
+}
+
+QJsonObject GateServer::handleReset(const QJsonObject &request)
+{
+    QJsonObject response;
+    const QString email = request["email"].toString();
+    response["email"] = email;
+    auto it = _users.find(email);
+    if (request["verifycode"].toString() != _verifyCode) {
+        response["error"] = VerifyCodeErr;
+    } else if (request["passwd"].toString() != request["confirm"].toString()) {
+        response["error"] = PasswdErr;
+    } else if (it == _users.end()) {
+        response["error"] = UserEmailNotExists;
+    } else if (it->name != request["user"].toString()) {
+        response["error"] = UserMailNotMatch;
+    } else {
+        it->passwd = xorString(request["passwd"].toString());
+        response["error"] = SUCCESS;
+    }
+    return response;
+}
+
+// 登录请求里的密码是明文
+QJsonObject GateServer::handleLogin(const QJsonObject &request)
+{
+    QJsonObject response;
+    const QString email = request["email"].toString();
+    response["email"] = email;
+    auto it = _users.find(email);
+    if (it == _users.end()) {
+        it = _users.insert(email, {_nextUid++, email.section('@', 0, 0), request["passwd"].toString()});
+    } else if (it->passwd != request["passwd"].toString()) {
+        response["error"] = PasswdInvalid;
+        return response;
+    }
+    response["error"] = SUCCESS;
+    response["uid"] = it->uid;
+    response["host"] = _chatHost;
+    response["port"] = QString::number(_chatPort); // 客户端按字符串读取
+    response["token"] = QString::number(QRandomGenerator::global()->generate64(), 16);
+    return response;
+}
+
+void GateServer::respond(QTcpSocket *socket, int status, const QByteArray &body, bool keepAlive)
+{
+    QByteArray response = "HTTP/1.1 " + QByteArray::number(status) + ' ' + reasonPhrase(status) + "\r\n"
+                          "Content-Type: application/json\r\n"
+                          "Content-Length: " + QByteArray::number(body.size()) + "\r\n"
+                          "Connection: " + (keepAlive ? "keep-alive" : "close") + "\r\n\r\n";
+    response.append(body);
+    _shaper->write(socket, response);
+    if (!keepAlive) {
+        // 等排队的响应写出后再关
+        connect(socket, &QTcpSocket::bytesWritten, socket, [socket]() {
+            if (socket->bytesToWrite() == 0)
+                socket->disconnectFromHost();
+        });
+    }
+}
@@ -0,0 +1,62 @@
+#ifndef GATESERVER_H
+#define GATESERVER_H
+
+#include <QObject>
+#include <QTcpServer>
+#include <QTcpSocket>
+#include <QHash>
+#include <QJsonObject>
+
+class LinkShaper;
+
+/**
+ * @brief 本地替身网关服务器
+ * 只实现客户端HttpMgr用到的几个POST接口，HTTP/1.1直接在QTcpServer上解析，支持长连接。
+ * 用户表只在内存里：注册过的邮箱按密码校验，没注册过的邮箱登录时自动建号，方便压测脚本直接登录。
+ * 登录成功后把客户端指向同进程的聊天服务器。
+ */
+class GateServer : public QObject
+{
+    Q_OBJECT
+public:
+    GateServer(const QString &chatHost, quint16 chatPort, const QString &verifyCode,
+               LinkShaper *shaper, QObject *parent = nullptr);
+
+    bool listen(quint16 port);
+
+private slots:
+    void onNewConnection();
+    void onReadyRead();
+    void onDisconnected();
+
+private:
+    struct GateUser {
+        int uid;
+        QString name;
+        QString passwd; // 明文
+    };
+
+    // 从缓冲区取出一个完整请求，不完整时返回false
+    bool takeRequest(QByteArray &buffer, QByteArray &path, QByteArray &body, bool &keepAlive) const;
+    void handleRequest(QTcpSocket *socket, const QByteArray &path, const QByteArray &body, bool keepAlive);
+    QJsonObject handleVerifyCode(const QJsonObject &request);
+    QJsonObject handleRegister(const QJsonObject &request);
+    QJsonObject handleReset(const QJsonObject &request);
+    QJsonObject handleLogin(const QJsonObject &request);
+    void respond(QTcpSocket *socket, int status, const QByteArray &body, bool keepAlive);
+
+    QTcpServer _server;
+    QHash<QTcpSocket*, QByteArray> _buffers; // 每个连接的接收缓冲
+    QHash<QString, GateUser> _users;         // 邮箱 -> 用户
+    QString _chatHost;
+    quint16 _chatPort;
+    QString _verifyCode;
+    LinkShaper *_shaper;
+    int _nextUid;
+    qint64 _requests;
+
+    static const int MAX_HEADER_BYTES = 8192; // 请求头上限，超过视为异常连接
+    static const int FIRST_UID = 10000;
+};
+
+#endif // GATESERVER_H
@@ -0,0 +1,56 @@
+#include "linkshaper.h"
+#include <QTcpSocket>
+#include <QTimer>
+#include <QRandomGenerator>
+#include <QDebug>
+
+LinkShaper::LinkShaper(const LinkProfile &profile, QObject *parent)
+    : QObject(parent), _profile(profile), _retransmits(0)
+{
+    _clock.start();
+    if (!isIdeal()) {
+        qDebug() << "链路劣化: 延迟" << _profile.latencyMs << "ms, 抖动" << _profile.jitterMs
+                 << "ms, 丢包" << _profile.lossPercent << "%";
+    }
+}
+
+bool LinkShaper::isIdeal() const
+{
+    return _profile.latencyMs <= 0 && _profile.jitterMs <= 0 && _profile.lossPercent <= 0;
+}
+
+void LinkShaper::write(QTcpSocket *socket, const QByteArray &data)
+{
+    if (isIdeal()) {
+        socket->write(data);
+        return;
+    }
+
+    QRandomGenerator *gen = QRandomGenerator::global();
+    qint64 delay = _profile.latencyMs;
+    if (_profile.jitterMs > 0)
+        delay += gen->bounded(-_profile.jitterMs, _profile.jitterMs + 1);
+    if (_profile.lossPercent > 0 && gen->generateDouble() * 100 < _profile.lossPercent) {
+        delay += RETRANSMIT_TIMEOUT;
+        if (++_retransmits % 100 == 1)
+            qDebug() << "模拟重传累计" << _retransmits << "次";
+    }
+
+    // 抖动不能让后发的报文跑到前面去；至少延后1ms，让所有报文都走定时器队列，
+    // 0ms的singleShot走的是投递事件，可能插到同一时刻到期的定时器前面
+    const qint64 now = _clock.elapsed();
+    qint64 &lastDue = _lastDue[socket];
+    const qint64 due = qMax(now + qMax<qint64>(1, delay), lastDue);
+    lastDue = due;
+
+    // 以socket为上下文，连接先被销毁时定时器自动作废
+    QTimer::singleShot(int(due - now), Qt::PreciseTimer, socket, [socket, data]() {
+        if (socket->state() == QAbstractSocket::ConnectedState)
+            socket->write(data);
+    });
+}
+
+void LinkShaper::forget(QTcpSocket *socket)
+{
+    _lastDue.remove(socket);
+}
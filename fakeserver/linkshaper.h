@@ -0,0 +1,48 @@
+#ifndef LINKSHAPER_H
+#define LINKSHAPER_H
+
+#include <QObject>
+#include <QHash>
+#include <QElapsedTimer>
+
+class QTcpSocket;
+
+// 链路劣化参数，全部为0时直接写socket
+struct LinkProfile {
+    int latencyMs;      // 固定延迟
+    int jitterMs;       // 延迟抖动（±）
+    double lossPercent; // 丢包率（百分比）
+
+    LinkProfile() : latencyMs(0), jitterMs(0), lossPercent(0) {}
+};
+
+/**
+ * @brief 链路劣化
+ * 服务器的所有回包和推送都经过这里，按配置的延迟、抖动和丢包推迟写出。
+ * TCP下丢包不会丢报文，而是等重传：被"丢"的报文多等一个重传超时，
+ * 同一连接上排在它后面的报文也随之推迟（队头阻塞），报文顺序始终不变。
+ */
+class LinkShaper : public QObject
+{
+    Q_OBJECT
+public:
+    explicit LinkShaper(const LinkProfile &profile, QObject *parent = nullptr);
+
+    // 按劣化参数安排写出
+    void write(QTcpSocket *socket, const QByteArray &data);
+    // 连接断开时清掉排队状态
+    void forget(QTcpSocket *socket);
+    const LinkProfile &profile() const { return _profile; }
+
+private:
+    bool isIdeal() const;
+
+    LinkProfile _profile;
+    QElapsedTimer _clock;
+    QHash<QTcpSocket*, qint64> _lastDue; // 每个连接最后一个报文的计划写出时间，保证顺序
+    qint64 _retransmits;                 // 模拟重传的报文数
+
+    static const int RETRANSMIT_TIMEOUT = 200; // 模拟的重传超时（毫秒），即Linux的最小RTO
+};
+
+#endif // LINKSHAPER_H
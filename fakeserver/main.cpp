@@ -0,0 +1,46 @@
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include "chatserver.h"
+#include "gateserver.h"
+#include "linkshaper.h"
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication a(argc, argv);
+    QCoreApplication::setApplicationName("fakeserver");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("本地替身服务器（网关+聊天），用于联调和压测客户端");
+    parser.addHelpOption();
+    QCommandLineOption gatePortOption("gate-port", "网关HTTP端口，与config.ini一致", "port", "8080");
+    QCommandLineOption chatHostOption("chat-host", "登录响应中下发的聊天服务器地址", "host", "127.0.0.1");
+    QCommandLineOption chatPortOption("chat-port", "聊天服务器端口", "port", "8090");
+    QCommandLineOption verifyCodeOption("verify-code", "注册和重置密码接受的验证码", "code", "123456");
+    QCommandLineOption conversationsOption("conversations", "初始会话数", "count", "10000");
+    QCommandLineOption mutationsOption("mutations", "每秒会话变更数", "count", "20");
+    QCommandLineOption messageRateOption("message-rate", "每秒产生的新消息数，推送给所有已登录连接", "count", "0");
+    QCommandLineOption latencyOption("latency", "每个回包和推送的附加延迟（毫秒）", "ms", "0");
+    QCommandLineOption jitterOption("jitter", "延迟抖动（毫秒，±）", "ms", "0");
+    QCommandLineOption lossOption("loss", "丢包率（百分比），按TCP重传超时折算成延迟", "percent", "0");
+    parser.addOptions({gatePortOption, chatHostOption, chatPortOption, verifyCodeOption, conversationsOption,
+                       mutationsOption, messageRateOption, latencyOption, jitterOption, lossOption});
+    parser.process(a);
+
+    LinkProfile profile;
+    profile.latencyMs = parser.value(latencyOption).toInt();
+    profile.jitterMs = parser.value(jitterOption).toInt();
+    profile.lossPercent = parser.value(lossOption).toDouble();
+    LinkShaper shaper(profile);
+
+    const quint16 chatPort = static_cast<quint16>(parser.value(chatPortOption).toUInt());
+    ChatServer chatServer(parser.value(conversationsOption).toInt(), parser.value(mutationsOption).toInt(),
+                          parser.value(messageRateOption).toInt(), &shaper);
+    if (!chatServer.listen(chatPort))
+        return 1;
+
+    GateServer gateServer(parser.value(chatHostOption), chatPort, parser.value(verifyCodeOption), &shaper);
+    if (!gateServer.listen(static_cast<quint16>(parser.value(gatePortOption).toUInt())))
+        return 1;
+
+    return a.exec();
+}
@@ -0,0 +1,32 @@
+#ifndef PROTOCOL_H
+#define PROTOCOL_H
+
+// 与客户端global.h中的ReqId保持一致
+enum ReqId {
+    ID_CHAT_LOGIN = 1005, // 聊天登录
+    ID_CHAT_LOGIN_RSP = 1006, // 聊天登录响应
+    ID_SYNC_CHAT_LIST = 1007, // 会话列表增量同步
+    ID_SYNC_CHAT_LIST_RSP = 1008, // 会话列表增量同步响应
+    ID_NOTIFY_CHAT_MSG = 1009, // 服务器推送的新消息
+    ID_SEND_CHAT_MSG = 1010, // 发送消息（发件箱）
+    ID_SEND_CHAT_MSG_ACK = 1011, // 发送消息的累计确认
+};
+
+// 与客户端global.h中的ErrorCodes保持一致（只列出网关会返回的）
+enum ErrorCodes {
+    SUCCESS = 0,
+    Error_Json = 1001,          // JSON解析失败
+    VerifyCodeErr = 1004,       // 验证码错误
+    PasswdErr = 1006,           // 密码错误
+    UserMailNotMatch = 1007,    // 邮箱不匹配
+    PasswdInvalid = 1009,       // 密码无效
+    UserEmailExists = 2000,     // 用户或邮箱存在
+    UserEmailNotExists = 2004,  // 用户或邮箱不存在
+};
+
+// 报文头：消息ID和消息体长度，各2字节（大端）
+const int HEADER_SIZE = 4;
+// 消息体长度字段只有16位
+const int MAX_BODY_SIZE = 65535;
+
+#endif // PROTOCOL_H
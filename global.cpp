@@ -7,6 +7,10 @@ std::function<void(QWidget*)> repolish = [](QWidget* w){
 
 QString gate_url_prefix = "";
 
+QElapsedTimer app_start_timer;
+
+QElapsedTimer login_timer;
+
 std::function<QString(QString)> xorString = [](QString input){
     QString result = input;
     int length = input.length();
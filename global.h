@@ -12,14 +12,17 @@
 #include <QJsonObject>
 #include <QDir>  // 用于处理文件目录的（反）斜杠
 #include <QSettings>
+#include <QElapsedTimer>
 
 /**
- * @brief repolish 用于刷新QSS
+ * @brief repolish 重新polish控件，让state等动态属性对应的样式生效
  */
 // 头文件定义函数需要用extern
 extern std::function<void(QWidget*)> repolish; //预先声明有这个函数，让编译器去cpp文件找这个函数
 extern QString gate_url_prefix;
 extern std::function<QString(QString)> xorString;
+extern QElapsedTimer app_start_timer; // 进程启动计时，main开头启动
+extern QElapsedTimer login_timer; // 点击登录时启动，统计登录到进入聊天各阶段的耗时
 
 enum ReqId{
     ID_GET_VERIFY_CODE = 1001, //请求验证码
@@ -28,8 +31,17 @@ enum ReqId{
     ID_LOGIN_USER = 1004, //登录用户
     ID_CHAT_LOGIN = 1005, // 聊天登录
     ID_CHAT_LOGIN_RSP = 1006, // 聊天登录响应
+    ID_SYNC_CHAT_LIST = 1007, // 会话列表增量同步
+    ID_SYNC_CHAT_LIST_RSP = 1008, // 会话列表增量同步响应
+    ID_NOTIFY_CHAT_MSG = 1009, // 服务器推送的新消息
+    ID_SEND_CHAT_MSG = 1010, // 发送消息（发件箱）
+    ID_SEND_CHAT_MSG_ACK = 1011, // 发送消息的累计确认
 };
 
+// 聊天通道的消息ID范围，TcpMgr的分发表按它分配，新增消息ID时同步修改
+const int TCP_MSG_ID_FIRST = ID_CHAT_LOGIN;
+const int TCP_MSG_ID_LAST = ID_SEND_CHAT_MSG_ACK;
+
 enum Modules{
     REGISTERMOD = 1, // 注册模块
     RESETMOD = 2, // 重置密码
@@ -0,0 +1,169 @@
+#ifndef JSONSCHEMA_H
+#define JSONSCHEMA_H
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QJsonArray>
+#include <QJsonValue>
+#include <QString>
+#include <QVector>
+#include <QPair>
+#include <tuple>
+
+/**
+ * 报文结构体的JSON字段描述与解码
+ * 结构体用静态成员函数fields()列出各字段的键名、成员指针和是否必需，
+ * 解码代码由模板按成员类型在编译期展开，类型不符或缺少必需字段时给出统一格式的错误。
+ * 支持的成员类型：int、qint64、bool、QString、QVector<T>、QPair<int, int>（两元素数组）、
+ * 以及同样带fields()的嵌套结构体。
+ */
+
+template <typename T, typename M>
+struct JsonField {
+    const char *key;
+    M T::*member;
+    bool required;
+};
+
+template <typename T, typename M>
+constexpr JsonField<T, M> requiredField(const char *key, M T::*member)
+{
+    return JsonField<T, M>{key, member, true};
+}
+
+// 可选字段缺失或为null时保留成员的默认值
+template <typename T, typename M>
+constexpr JsonField<T, M> optionalField(const char *key, M T::*member)
+{
+    return JsonField<T, M>{key, member, false};
+}
+
+// 各类型的读取函数，失败时在error里写明原因
+inline bool readJson(const QJsonValue &value, int &out, QString &error)
+{
+    if (!value.isDouble()) {
+        error = "应为数字";
+        return false;
+    }
+    out = value.toInt();
+    return true;
+}
+
+inline bool readJson(const QJsonValue &value, qint64 &out, QString &error)
+{
+    if (!value.isDouble()) {
+        error = "应为数字";
+        return false;
+    }
+    out = value.toInteger();
+    return true;
+}
+
+inline bool readJson(const QJsonValue &value, bool &out, QString &error)
+{
+    if (!value.isBool()) {
+        error = "应为布尔值";
+        return false;
+    }
+    out = value.toBool();
+    return true;
+}
+
+inline bool readJson(const QJsonValue &value, QString &out, QString &error)
+{
+    if (!value.isString()) {
+        error = "应为字符串";
+        return false;
+    }
+    out = value.toString();
+    return true;
+}
+
+inline bool readJson(const QJsonValue &value, QPair<int, int> &out, QString &error)
+{
+    const QJsonArray pair = value.toArray();
+    if (!value.isArray() || pair.size() != 2 || !pair.at(0).isDouble() || !pair.at(1).isDouble()) {
+        error = "应为两个数字组成的数组";
+        return false;
+    }
+    out = qMakePair(pair.at(0).toInt(), pair.at(1).toInt());
+    return true;
+}
+
+template <typename E>
+bool readJson(const QJsonValue &value, QVector<E> &out, QString &error);
+
+template <typename T>
+auto readJson(const QJsonValue &value, T &out, QString &error) -> decltype(T::fields(), bool());
+
+template <typename T, typename M>
+bool readJsonField(const QJsonObject &object, T &out, const JsonField<T, M> &field, QString &error)
+{
+    const auto it = object.constFind(QLatin1String(field.key));
+    if (it == object.constEnd() || it->isNull()) {
+        if (field.required) {
+            error = QString("缺少字段%1").arg(QLatin1String(field.key));
+            return false;
+        }
+        return true;
+    }
+    QString inner;
+    if (!readJson(*it, out.*field.member, inner)) {
+        error = QString("%1: %2").arg(QLatin1String(field.key), inner);
+        return false;
+    }
+    return true;
+}
+
+template <typename E>
+bool readJson(const QJsonValue &value, QVector<E> &out, QString &error)
+{
+    if (!value.isArray()) {
+        error = "应为数组";
+        return false;
+    }
+    const QJsonArray array = value.toArray();
+    out.resize(array.size());
+    for (int i = 0; i < array.size(); ++i) {
+        QString inner;
+        if (!readJson(array.at(i), out[i], inner)) {
+            error = QString("[%1] %2").arg(i).arg(inner);
+            return false;
+        }
+    }
+    return true;
+}
+
+// 带fields()的结构体：逐个字段读取，遇到第一个错误即停止
+template <typename T>
+auto readJson(const QJsonValue &value, T &out, QString &error) -> decltype(T::fields(), bool())
+{
+    if (!value.isObject()) {
+        error = "应为对象";
+        return false;
+    }
+    const QJsonObject object = value.toObject();
+    bool ok = true;
+    std::apply([&](const auto &...field) {
+        ((ok = ok && readJsonField(object, out, field, error)), ...);
+    }, T::fields());
+    return ok;
+}
+
+// 解析整个报文体
+template <typename T>
+bool decodeJson(const QByteArray &body, T &out, QString &error)
+{
+    QJsonParseError parseError;
+    const QJsonDocument doc = QJsonDocument::fromJson(body, &parseError);
+    if (parseError.error != QJsonParseError::NoError) {
+        error = "JSON解析失败: " + parseError.errorString();
+        return false;
+    }
+    if (!doc.isObject()) {
+        error = "应为对象";
+        return false;
+    }
+    return readJson(QJsonValue(doc.object()), out, error);
+}
+
+#endif // JSONSCHEMA_H
@@ -0,0 +1,286 @@
+#include "localdb.h"
+#include <QSqlQuery>
+#include <QSqlError>
+#include <QStandardPaths>
+#include <QCoreApplication>
+#include <QElapsedTimer>
+
+LocalDb::LocalDb()
+{
+    _flushTimer.setSingleShot(true);
+    _flushTimer.setInterval(FLUSH_INTERVAL);
+    connect(&_flushTimer, &QTimer::timeout, this, &LocalDb::flush);
+    // 退出前把队列里的写入落盘
+    connect(qApp, &QCoreApplication::aboutToQuit, this, &LocalDb::flush);
+    open();
+}
+
+LocalDb::~LocalDb()
+{
+    flush();
+    _db.close();
+}
+
+QString LocalDb::databasePath()
+{
+    return QDir(QStandardPaths::writableLocation(QStandardPaths::AppDataLocation)).filePath("baijiu.db");
+}
+
+bool LocalDb::open()
+{
+    QDir().mkpath(QStandardPaths::writableLocation(QStandardPaths::AppDataLocation));
+    _db = QSqlDatabase::addDatabase("QSQLITE", "local");
+    _db.setDatabaseName(databasePath());
+    if (!_db.open()) {
+        qDebug() << "本地数据库打开失败:" << _db.lastError().text();
+        return false;
+    }
+    // WAL模式下读写互不阻塞，NORMAL同步级别在WAL下仍能保证一致性
+    exec("PRAGMA journal_mode=WAL");
+    exec("PRAGMA synchronous=NORMAL");
+    if (!createTables())
+        return false;
+    ensureColumn("conversations", "is_group", "INTEGER DEFAULT 0");
+    return true;
+}
+
+void LocalDb::ensureColumn(const QString &table, const QString &column, const QString &definition)
+{
+    QSqlQuery query(_db);
+    if (!query.exec(QString("PRAGMA table_info(%1)").arg(table)))
+        return;
+    while (query.next()) {
+        if (query.value(1).toString() == column)
+            return;
+    }
+    exec(QString("ALTER TABLE %1 ADD COLUMN %2 %3").arg(table, column, definition));
+}
+
+bool LocalDb::createTables()
+{
+    return exec("CREATE TABLE IF NOT EXISTS conversations ("
+                "id INTEGER PRIMARY KEY, avatar TEXT, name TEXT, preview TEXT, "
+                "time_ms INTEGER, unread INTEGER, muted INTEGER, is_group INTEGER DEFAULT 0)")
+           && exec("CREATE TABLE IF NOT EXISTS messages ("
+                   "chat_id INTEGER, seq INTEGER, outgoing INTEGER, text TEXT, time_ms INTEGER, "
+                   "PRIMARY KEY (chat_id, seq)) WITHOUT ROWID")
+           && exec("CREATE TABLE IF NOT EXISTS meta (key TEXT PRIMARY KEY, value TEXT)");
+}
+
+bool LocalDb::exec(const QString &sql)
+{
+    QSqlQuery query(_db);
+    if (!query.exec(sql)) {
+        qDebug() << "SQL执行失败:" << sql << query.lastError().text();
+        return false;
+    }
+    return true;
+}
+
+QVector<ChatItemData> LocalDb::loadConversations()
+{
+    QVector<ChatItemData> items;
+    if (!isOpen())
+        return items;
+
+    QElapsedTimer timer;
+    timer.start();
+    QSqlQuery query(_db);
+    query.setForwardOnly(true);
+    if (!query.exec("SELECT id, avatar, name, preview, time_ms, unread, muted, is_group FROM conversations")) {
+        qDebug() << "读取会话失败:" << query.lastError().text();
+        return items;
+    }
+    while (query.next()) {
+        items.append(ChatItemData(query.value(0).toInt(), query.value(1).toString(),
+                                  query.value(2).toString(), query.value(3).toString(),
+                                  QDateTime::fromMSecsSinceEpoch(query.value(4).toLongLong()),
+                                  query.value(5).toInt(), query.value(6).toBool(), true,
+                                  query.value(7).toBool()));
+    }
+    qDebug() << "从本地读取会话:" << items.size() << "项, 耗时" << timer.elapsed() << "ms";
+    return items;
+}
+
+void LocalDb::clearConversations()
+{
+    _pendingConversations.clear();
+    if (isOpen())
+        exec("DELETE FROM conversations");
+}
+
+int LocalDb::messageCount(int chatId)
+{
+    QSqlQuery query(_db);
+    query.prepare("SELECT COUNT(*) FROM messages WHERE chat_id = ?");
+    query.addBindValue(chatId);
+    if (!query.exec() || !query.next())
+        return 0;
+    return query.value(0).toInt();
+}
+
+QPair<int, int> LocalDb::messageRange(int chatId)
+{
+    QSqlQuery query(_db);
+    query.prepare("SELECT MIN(seq), MAX(seq) FROM messages WHERE chat_id = ?");
+    query.addBindValue(chatId);
+    if (!query.exec() || !query.next() || query.value(0).isNull())
+        return qMakePair(0, 0);
+    return qMakePair(query.value(0).toInt(), query.value(1).toInt() + 1);
+}
+
+QVector<MessageData> LocalDb::fetchMessages(int chatId, int begin, int count)
+{
+    QVector<MessageData> page;
+    // 先落盘队列中的消息，保证刚追加的消息能读到
+    if (!_pendingMessages.isEmpty())
+        flush();
+    QSqlQuery query(_db);
+    query.setForwardOnly(true);
+    query.prepare("SELECT seq, outgoing, text, time_ms FROM messages "
+                  "WHERE chat_id = ? AND seq >= ? AND seq < ? ORDER BY seq");
+    query.addBindValue(chatId);
+    query.addBindValue(begin);
+    query.addBindValue(begin + count);
+    if (!query.exec()) {
+        qDebug() << "读取消息失败:" << query.lastError().text();
+        return page;
+    }
+    page.reserve(count);
+    while (query.next()) {
+        int seq = query.value(0).toInt();
+        page.append(MessageData((qint64(chatId) << 32) | quint32(seq), chatId, query.value(1).toBool(),
+                                query.value(2).toString(), query.value(3).toLongLong()));
+    }
+    return page;
+}
+
+void LocalDb::enqueueConversation(const ChatItemData &data)
+{
+    _pendingConversations.insert(data.id, data);
+    if (_pendingConversations.size() + _pendingMessages.size() >= MAX_BATCH)
+        flush();
+    else if (!_flushTimer.isActive())
+        _flushTimer.start();
+}
+
+void LocalDb::enqueueMessage(const MessageData &message)
+{
+    _pendingMessages.append(message);
+    if (_pendingConversations.size() + _pendingMessages.size() >= MAX_BATCH)
+        flush();
+    else if (!_flushTimer.isActive())
+        _flushTimer.start();
+}
+
+void LocalDb::flush()
+{
+    _flushTimer.stop();
+    if (!isOpen() || (_pendingConversations.isEmpty() && _pendingMessages.isEmpty() && _pendingMeta.isEmpty()))
+        return;
+
+    QElapsedTimer timer;
+    timer.start();
+    const int conversationCount = _pendingConversations.size();
+    const int messageTotal = _pendingMessages.size();
+
+    if (!_db.transaction()) {
+        qDebug() << "本地落盘开启事务失败，稍后重试:" << _db.lastError().text();
+        _flushTimer.start();
+        return;
+    }
+    QSqlQuery upsert(_db);
+    upsert.prepare("INSERT OR REPLACE INTO conversations (id, avatar, name, preview, time_ms, unread, muted, is_group) "
+                   "VALUES (?, ?, ?, ?, ?, ?, ?, ?)");
+    QSqlQuery remove(_db);
+    remove.prepare("DELETE FROM conversations WHERE id = ?");
+    for (const ChatItemData &data : std::as_const(_pendingConversations)) {
+        if (!data.isValid) {
+            remove.addBindValue(data.id);
+            remove.exec();
+            continue;
+        }
+        upsert.addBindValue(data.id);
+        upsert.addBindValue(data.avatarPath);
+        upsert.addBindValue(data.name);
+        upsert.addBindValue(data.lastMessage);
+        upsert.addBindValue(data.lastMessageTime.toMSecsSinceEpoch());
+        upsert.addBindValue(data.unreadCount);
+        upsert.addBindValue(data.muted);
+        upsert.addBindValue(data.isGroup);
+        if (!upsert.exec())
+            qDebug() << "写入会话失败:" << upsert.lastError().text();
+    }
+
+    QSqlQuery insert(_db);
+    insert.prepare("INSERT OR REPLACE INTO messages (chat_id, seq, outgoing, text, time_ms) VALUES (?, ?, ?, ?, ?)");
+    for (const MessageData &message : std::as_const(_pendingMessages)) {
+        insert.addBindValue(message.chatId);
+        insert.addBindValue(int(message.id & 0xFFFFFFFF));
+        insert.addBindValue(message.outgoing);
+        insert.addBindValue(message.text);
+        insert.addBindValue(message.timeMs);
+        if (!insert.exec())
+            qDebug() << "写入消息失败:" << insert.lastError().text();
+    }
+
+    // 配置放在最后，游标之类的值不会先于它描述的数据落盘
+    QSqlQuery meta(_db);
+    meta.prepare("INSERT OR REPLACE INTO meta (key, value) VALUES (?, ?)");
+    for (auto it = _pendingMeta.cbegin(); it != _pendingMeta.cend(); ++it) {
+        meta.addBindValue(it.key());
+        meta.addBindValue(it.value());
+        if (!meta.exec())
+            qDebug() << "写入配置失败:" << it.key() << meta.lastError().text();
+    }
+    // 提交失败时整批回滚，队列原样保留，下一次落盘重试
+    if (!_db.commit()) {
+        qDebug() << "本地落盘提交失败，稍后重试:" << _db.lastError().text();
+        _db.rollback();
+        _flushTimer.start();
+        return;
+    }
+
+    _pendingConversations.clear();
+    _pendingMessages.clear();
+    _pendingMeta.clear();
+    qDebug() << "本地落盘: 会话" << conversationCount << "项, 消息" << messageTotal << "条, 耗时"
+             << timer.elapsed() << "ms";
+}
+
+QString LocalDb::metaValue(const QString &key, const QString &defaultValue)
+{
+    auto pending = _pendingMeta.constFind(key);
+    if (pending != _pendingMeta.constEnd())
+        return pending.value();
+    QSqlQuery query(_db);
+    query.prepare("SELECT value FROM meta WHERE key = ?");
+    query.addBindValue(key);
+    if (!query.exec() || !query.next())
+        return defaultValue;
+    return query.value(0).toString();
+}
+
+void LocalDb::setMetaValue(const QString &key, const QString &value)
+{
+    QSqlQuery query(_db);
+    query.prepare("INSERT OR REPLACE INTO meta (key, value) VALUES (?, ?)");
+    query.addBindValue(key);
+    query.addBindValue(value);
+    if (!query.exec())
+        qDebug() << "写入配置失败:" << key << query.lastError().text();
+}
+
+void LocalDb::clearAllUnread()
+{
+    flush();
+    if (isOpen())
+        exec("UPDATE conversations SET unread = 0 WHERE unread != 0");
+}
+
+void LocalDb::enqueueMetaValue(const QString &key, const QString &value)
+{
+    _pendingMeta.insert(key, value);
+    if (!_flushTimer.isActive())
+        _flushTimer.start();
+}
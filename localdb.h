@@ -0,0 +1,72 @@
+#ifndef LOCALDB_H
+#define LOCALDB_H
+#include <QObject>
+#include <QTimer>
+#include <QSqlDatabase>
+#include <QHash>
+#include <QPair>
+#include "singleton.h"
+#include "chatitemdata.h"
+#include "messagedata.h"
+
+/**
+ * @brief 本地持久化存储
+ * SQLite（WAL模式）保存会话列表和消息，启动时不依赖网络即可恢复会话列表；
+ * 运行中的写入先进入写后队列，按固定间隔或攒够一批后在一个事务里落盘。
+ */
+class LocalDb : public QObject, public Singleton<LocalDb>,
+                public std::enable_shared_from_this<LocalDb>
+{
+    Q_OBJECT
+public:
+    friend class Singleton<LocalDb>;
+    ~LocalDb();
+
+    bool isOpen() const { return _db.isOpen(); }
+    // 数据库文件路径（WAL模式下旁边还有-wal、-shm两个文件）
+    static QString databasePath();
+
+    // 读出全部会话
+    QVector<ChatItemData> loadConversations();
+    // 删除全部会话（连同排队中的会话写入）
+    void clearConversations();
+    // 会话的落盘消息数
+    int messageCount(int chatId);
+    // 会话落盘消息的序号范围[first, end)，没有消息时为(0, 0)
+    QPair<int, int> messageRange(int chatId);
+    // 取会话内序号[begin, begin + count)的消息
+    QVector<MessageData> fetchMessages(int chatId, int begin, int count);
+
+    // 写后队列：isValid为false表示删除该会话，同一会话只保留最后一次
+    void enqueueConversation(const ChatItemData &data);
+    void enqueueMessage(const MessageData &message);
+    // 立即把队列写入磁盘
+    void flush();
+    // 所有会话未读清零（先落盘队列，再用一条语句更新）
+    void clearAllUnread();
+
+    // 键值配置（同步游标等）
+    QString metaValue(const QString &key, const QString &defaultValue = QString());
+    void setMetaValue(const QString &key, const QString &value);
+    // 经写后队列写入配置，与之前排队的会话在同一事务或更晚的事务中落盘
+    void enqueueMetaValue(const QString &key, const QString &value);
+
+private:
+    LocalDb();
+    bool open();
+    bool createTables();
+    bool exec(const QString &sql);
+    // 旧库缺少的列在这里补上
+    void ensureColumn(const QString &table, const QString &column, const QString &definition);
+
+    QSqlDatabase _db;
+    QTimer _flushTimer;                             // 写后队列定时器
+    QHash<int, ChatItemData> _pendingConversations; // 待写入的会话（按id合并）
+    QVector<MessageData> _pendingMessages;          // 待写入的消息
+    QHash<QString, QString> _pendingMeta;           // 待写入的配置
+
+    static const int FLUSH_INTERVAL = 200;  // 写后队列最长延迟（毫秒）
+    static const int MAX_BATCH = 500;       // 攒够这么多条立即落盘
+};
+
+#endif // LOCALDB_H
@@ -1,5 +1,6 @@
 #include "logindialog.h"
 #include "ui_logindialog.h"
+#include <QTimer>
 
 LoginDialog::LoginDialog(QWidget *parent)
     : QDialog(parent)
@@ -13,14 +14,7 @@ LoginDialog::LoginDialog(QWidget *parent)
     repolish(ui->tip); // 刷新属性
     ui->pwdLineEdit->setEchoMode(QLineEdit::Password);
 
-    ui->forgetButton->setStyleSheet(R"(
-    QPushButton {
-        border: none;
-        background: transparent;
-    }
-    QPushButton:hover {
-        background-color: rgba(0, 0, 0, 0.05); /* 可选的悬浮反馈 */
-    })");
+    ui->forgetButton->setFlat(true); // 无边框按钮，悬停反馈由BaijiuStyle绘制
 
     togglePwdAction = new QAction(this);
     togglePwdAction->setIcon(QIcon(":/LogReg/res/eye_close.png"));
@@ -49,6 +43,13 @@ LoginDialog::LoginDialog(QWidget *parent)
     connect(TcpMgr::GetInstance().get(), &TcpMgr::sig_con_success, this, &LoginDialog::slot_tcp_con_finish);
     //登录失败
     connect(TcpMgr::GetInstance().get(), &TcpMgr::sig_login_failed, this, &LoginDialog::slot_login_failed);
+    // 设置BAIJIU_AUTO_LOGIN=邮箱:密码时自动登录，配合本地替身服务器压测登录到进入聊天的耗时
+    const QString autoLogin = qEnvironmentVariable("BAIJIU_AUTO_LOGIN");
+    if (!autoLogin.isEmpty()) {
+        ui->emailLineEdit->setText(autoLogin.section(':', 0, 0));
+        ui->pwdLineEdit->setText(autoLogin.section(':', 1));
+        QTimer::singleShot(0, this, &LoginDialog::on_loginButton_clicked);
+    }
 }
 
 LoginDialog::~LoginDialog()
@@ -141,6 +142,7 @@ void LoginDialog::on_loginButton_clicked()
     QJsonObject json_obj;
     json_obj["email"] = email;
     json_obj["passwd"] = pwd;
+    login_timer.start();
     HttpMgr::GetInstance()->PostHttpReq(QUrl(gate_url_prefix + "/user_login"), json_obj, ReqId::ID_LOGIN_USER, Modules::LOGINMOD);
 }
 
@@ -163,6 +165,7 @@ void LoginDialog::slot_login_mod_finish(ReqId id, QString res, ErrorCodes err)
 void LoginDialog::slot_tcp_con_finish(bool bsuccess)
 {
     if(bsuccess){
+        qDebug() << "聊天服务器已连接: 距点击登录" << login_timer.elapsed() << "ms";
         showTip(tr("连接成功，正在登录"), true);
         QJsonObject jsonObj;
         jsonObj["uid"] = _uid;
@@ -203,6 +206,7 @@ void LoginDialog::initHttpHandlers()
 
         _uid = serverInfo.Uid;
         _token = serverInfo.Token;
+        qDebug() << "网关登录响应: 距点击登录" << login_timer.elapsed() << "ms";
         qDebug()<< "email is " << email << " uid is " << serverInfo.Uid <<" host is "
                  << serverInfo.Host << " Port is " << serverInfo.Port << " Token is " << serverInfo.Token;
         emit sig_connect_tcp(serverInfo);
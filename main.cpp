@@ -1,23 +1,37 @@
 #include "mainwindow.h"
 #include "global.h"
+#include "localdb.h"
+#include "startuptracer.h"
+#include "thememgr.h"
+#include "tcpmgr.h"
+#include "tcpreplayer.h"
 #include <QApplication>
 #include <QFile>
+#include <QResource>
+#include <QStandardPaths>
 #include <QDebug>
 
 int main(int argc, char *argv[])
 {
+    app_start_timer.start();
+    StartupTracer::GetInstance()->begin("QApplication");
     QApplication a(argc, argv);
-    // 读取QSS文件配置
-    QFile qss(":/LogReg/style/stylesheet.qss");
-    if (qss.open(QFile::ReadOnly)){
-        qDebug() << "打开成功";
-        QString style = QLatin1String(qss.readAll());
-        a.setStyleSheet(style);
-        qss.close();
-    }else{
-        qDebug() << "打开qss失败";
+    StartupTracer::GetInstance()->end("QApplication");
+#ifdef BAIJIU_EXTERNAL_AVATARS
+    // 头像打包在可执行文件旁的avatars.rcc里，注册时只做内存映射，解码时才会读到对应的页
+    StartupTracer::GetInstance()->begin("注册头像资源");
+    const QString avatarRcc = QCoreApplication::applicationDirPath() + "/avatars.rcc";
+    if (!QResource::registerResource(avatarRcc)) {
+        qDebug() << "注册头像资源失败:" << avatarRcc;
     }
+    StartupTracer::GetInstance()->end("注册头像资源");
+#endif
+    // 安装应用样式和主题（取代全局QSS），BAIJIU_THEME=dark启动为深色主题
+    StartupTracer::GetInstance()->begin("安装主题样式");
+    ThemeMgr::GetInstance()->install(&a, qEnvironmentVariable("BAIJIU_THEME") == "dark" ? Theme::Dark : Theme::Light);
+    StartupTracer::GetInstance()->end("安装主题样式");
     // 读取config.ini文件配置
+    StartupTracer::GetInstance()->begin("读取config.ini");
     QString fileName = "config.ini";
     QString app_path = QCoreApplication::applicationDirPath();
     QString config_path = QDir::toNativeSeparators((app_path + QDir::separator() + fileName));
@@ -25,8 +39,35 @@ int main(int argc, char *argv[])
     QString gate_host = settings.value("GateServer/host").toString();
     QString gate_port = settings.value("GateServer/port").toString();
     gate_url_prefix = "http://" + gate_host+":"+gate_port;
+    StartupTracer::GetInstance()->end("读取config.ini");
+    // 设置BAIJIU_TCP_CAPTURE=文件时记录聊天通道收发的每一帧
+    if (qEnvironmentVariableIsSet("BAIJIU_TCP_CAPTURE")) {
+        TcpMgr::GetInstance()->setCaptureFile(qEnvironmentVariable("BAIJIU_TCP_CAPTURE"));
+    }
+    // 设置BAIJIU_TCP_REPLAY=抓包文件时不连服务器，回放其中收到的帧；本地库切到测试目录并清空，每次回放结果相同
+    const bool replay = qEnvironmentVariableIsSet("BAIJIU_TCP_REPLAY");
+    if (replay) {
+        QStandardPaths::setTestModeEnabled(true);
+        const QString dbPath = LocalDb::databasePath();
+        QFile::remove(dbPath);
+        QFile::remove(dbPath + "-wal");
+        QFile::remove(dbPath + "-shm");
+    }
+    StartupTracer::GetInstance()->begin("MainWindow构造");
     MainWindow w;
+    StartupTracer::GetInstance()->end("MainWindow构造");
     w.setWindowTitle("白久飞书");
     w.show();
-    return a.exec();
+    // BAIJIU_TCP_REPLAY_SPEED为倍速，max为全速；BAIJIU_TCP_REPLAY_EXIT设置时回放完退出
+    TcpReplayer replayer;
+    if (replay) {
+        const QString speed = qEnvironmentVariable("BAIJIU_TCP_REPLAY_SPEED", "1");
+        if (qEnvironmentVariableIsSet("BAIJIU_TCP_REPLAY_EXIT"))
+            QObject::connect(&replayer, &TcpReplayer::sig_finished, &a, &QApplication::quit, Qt::QueuedConnection);
+        if (!replayer.start(qEnvironmentVariable("BAIJIU_TCP_REPLAY"), speed == "max" ? 0 : speed.toDouble()))
+            return 1;
+    }
+    int ret = a.exec();
+    StartupTracer::GetInstance()->writeTraceIfRequested();
+    return ret;
 }
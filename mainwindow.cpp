@@ -1,42 +1,28 @@
 #include "mainwindow.h"
 #include "ui_mainwindow.h"
+#include "unreadmgr.h"
+#include "startuptracer.h"
+#include <QTimer>
+#include <QElapsedTimer>
 
 MainWindow::MainWindow(QWidget *parent)
     : QMainWindow(parent)
     , ui(new Ui::MainWindow)
+    , _login_Dlg(nullptr)
+    , _reg_Dlg(nullptr)
+    , _reset_Dlg(nullptr)
+    , _chat_Dlg(nullptr)
+    , _loginFramed(false)
 {
     ui->setupUi(this);
 
-    _login_Dlg = new LoginDialog(this); // 初始化
-    _reg_Dlg = new RegisterDialog(this);
-    _reset_Dlg = new ResetDialog(this);
-    _chat_Dlg = new ChatDialog(this);
-
-    _login_Dlg->setWindowFlags(Qt::FramelessWindowHint);
-    _reg_Dlg->setWindowFlags(Qt::FramelessWindowHint);
-    _reset_Dlg->setWindowFlags(Qt::FramelessWindowHint);
-
     _stackedWidget = new QStackedWidget(this);
-    _stackedWidget->addWidget(_login_Dlg);
-    _stackedWidget->addWidget(_reg_Dlg);
-    _stackedWidget->addWidget(_reset_Dlg);
-    _stackedWidget->addWidget(_chat_Dlg);
     setCentralWidget(_stackedWidget); // 和先后顺序有关
 
-    // 创建注册信号和槽
-    connect(_login_Dlg, &LoginDialog::registerRequest, this, &MainWindow::switchToRegister);
-    connect(_login_Dlg, &LoginDialog::resetRequest, this, &MainWindow::switchToReset);
-    connect(_reg_Dlg, &RegisterDialog::cancelRegister, this, &MainWindow::switchToLogin);
-    connect(_reset_Dlg, &ResetDialog::cancelReset, this, &MainWindow::switchToLogin);
+    // 各页面在第一次切换到时才创建，启动时只创建登录页
+    initPageFactories();
+    switchToLogin();
     connect(TcpMgr::GetInstance().get(), &TcpMgr::sig_switch_chatdlg, this, &MainWindow::switchToChat);
-    connect(_reg_Dlg, &RegisterDialog::registerSucceed, [this](const QString& email){
-        switchToLogin();
-        _login_Dlg->setEmail(email); // 自动填充邮箱
-    });
-    connect(_reset_Dlg, &ResetDialog::resetSucceed, [this](const QString& email){
-        switchToLogin();
-        _login_Dlg->setEmail(email); // 自动填充邮箱
-    });
 
     // customize指完全自定义窗口形式，包括取消默认的标题栏和边框
     // frameless是表示无边框
@@ -47,7 +33,15 @@ MainWindow::MainWindow(QWidget *parent)
     // ​无父窗口	可能有系统边框（需手动禁用）  	完全无边框
     // ​典型用途	自定义标题栏但保留边框         完全无边框（如游戏界面、悬浮弹窗）
 
-    emit TcpMgr::GetInstance()->sig_switch_chatdlg();  // 仅供测试用
+    // 窗口标题显示未免打扰会话的未读总数
+    connect(UnreadMgr::GetInstance().get(), &UnreadMgr::sig_unread_changed, this, [this](const UnreadTotals &totals){
+        setWindowTitle(totals.unmuted > 0 ? QString("白久飞书 (%1)").arg(totals.unmuted) : QString("白久飞书"));
+    });
+
+    // 仅供测试用：设置BAIJIU_SKIP_LOGIN时跳过登录直接进入聊天页
+    if (qEnvironmentVariableIsSet("BAIJIU_SKIP_LOGIN")) {
+        emit TcpMgr::GetInstance()->sig_switch_chatdlg();
+    }
 
 }
 
@@ -70,9 +64,80 @@ MainWindow::~MainWindow()
 
 }
 
+// 注册各页面的创建函数：创建控件、设置窗口属性并连接该页自己的信号
+void MainWindow::initPageFactories()
+{
+    _pageFactories.insert(PAGE_LOGIN, [this]() -> QWidget* {
+        _login_Dlg = new LoginDialog(this);
+        _login_Dlg->setWindowFlags(Qt::FramelessWindowHint);
+        _login_Dlg->installEventFilter(this); // 记录登录页首帧
+        connect(_login_Dlg, &LoginDialog::registerRequest, this, &MainWindow::switchToRegister);
+        connect(_login_Dlg, &LoginDialog::resetRequest, this, &MainWindow::switchToReset);
+        // 登录的HTTP请求成功后，趁连接聊天服务器的空档预先创建聊天页
+        connect(_login_Dlg, &LoginDialog::sig_connect_tcp, this, [this](ServerInfo){
+            QTimer::singleShot(0, this, [this]() { page(PAGE_CHAT); });
+        });
+        return _login_Dlg;
+    });
+    _pageFactories.insert(PAGE_REGISTER, [this]() -> QWidget* {
+        _reg_Dlg = new RegisterDialog(this);
+        _reg_Dlg->setWindowFlags(Qt::FramelessWindowHint);
+        connect(_reg_Dlg, &RegisterDialog::cancelRegister, this, &MainWindow::switchToLogin);
+        connect(_reg_Dlg, &RegisterDialog::registerSucceed, [this](const QString& email){
+            switchToLogin();
+            _login_Dlg->setEmail(email); // 自动填充邮箱
+        });
+        return _reg_Dlg;
+    });
+    _pageFactories.insert(PAGE_RESET, [this]() -> QWidget* {
+        _reset_Dlg = new ResetDialog(this);
+        _reset_Dlg->setWindowFlags(Qt::FramelessWindowHint);
+        connect(_reset_Dlg, &ResetDialog::cancelReset, this, &MainWindow::switchToLogin);
+        connect(_reset_Dlg, &ResetDialog::resetSucceed, [this](const QString& email){
+            switchToLogin();
+            _login_Dlg->setEmail(email); // 自动填充邮箱
+        });
+        return _reset_Dlg;
+    });
+    _pageFactories.insert(PAGE_CHAT, [this]() -> QWidget* {
+        _chat_Dlg = new ChatDialog(this);
+        return _chat_Dlg;
+    });
+}
+
+// 取页面，第一次访问时创建并加入栈
+QWidget *MainWindow::page(PageId id)
+{
+    QWidget *widget = _pages.value(id);
+    if (widget)
+        return widget;
+
+    QElapsedTimer timer;
+    timer.start();
+    static const char *const PAGE_NAMES[] = {"创建登录页", "创建注册页", "创建重置页", "创建聊天页"};
+    StartupTracer::GetInstance()->begin(PAGE_NAMES[id]);
+    widget = _pageFactories.value(id)();
+    StartupTracer::GetInstance()->end(PAGE_NAMES[id]);
+    _stackedWidget->addWidget(widget);
+    _pages.insert(id, widget);
+    qDebug() << "创建页面" << id << "耗时" << timer.elapsed() << "ms";
+    return widget;
+}
+
+// 登录页第一次绘制时输出启动耗时
+bool MainWindow::eventFilter(QObject *watched, QEvent *event)
+{
+    if (watched == _login_Dlg && event->type() == QEvent::Paint && !_loginFramed) {
+        _loginFramed = true;
+        qDebug() << "登录页首帧: 距启动" << app_start_timer.elapsed() << "ms";
+        StartupTracer::GetInstance()->markFirstFrame("登录页首帧");
+    }
+    return QMainWindow::eventFilter(watched, event);
+}
+
 void MainWindow::switchToRegister()
 {
-    _stackedWidget->setCurrentWidget(_reg_Dlg);
+    _stackedWidget->setCurrentWidget(page(PAGE_REGISTER));
     // setCentralWidget(_reg_Dlg);
     // _login_Dlg->hide();
     // _reg_Dlg->show();
@@ -80,7 +145,7 @@ void MainWindow::switchToRegister()
 
 void MainWindow::switchToLogin()
 {
-    _stackedWidget->setCurrentWidget(_login_Dlg);
+    _stackedWidget->setCurrentWidget(page(PAGE_LOGIN));
     // setCentralWidget(_login_Dlg);
     // _reg_Dlg->hide();
     // _login_Dlg->show();
@@ -88,11 +153,11 @@ void MainWindow::switchToLogin()
 
 void MainWindow::switchToReset()
 {
-    _stackedWidget->setCurrentWidget(_reset_Dlg);
+    _stackedWidget->setCurrentWidget(page(PAGE_RESET));
 }
 
 void MainWindow::switchToChat()
 {
     resize(1100, 700);
-    _stackedWidget->setCurrentWidget(_chat_Dlg);
+    _stackedWidget->setCurrentWidget(page(PAGE_CHAT));
 }
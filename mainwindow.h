@@ -3,6 +3,8 @@
 
 #include <QMainWindow>
 #include <QStackedWidget>
+#include <QHash>
+#include <functional>
 #include "logindialog.h"
 #include "registerdialog.h"
 #include "resetdialog.h"
@@ -37,12 +39,29 @@ protected slots:
     void switchToReset();
     void switchToChat();
 
+protected:
+    bool eventFilter(QObject *watched, QEvent *event) override;
+
 private:
+    // 栈中的页面
+    enum PageId {
+        PAGE_LOGIN,
+        PAGE_REGISTER,
+        PAGE_RESET,
+        PAGE_CHAT
+    };
+    void initPageFactories();
+    QWidget *page(PageId id);
+
+    QHash<int, std::function<QWidget*()>> _pageFactories; // 页面创建函数
+    QHash<int, QWidget*> _pages; // 已创建的页面
+
     Ui::MainWindow *ui;
     QStackedWidget *_stackedWidget;
     LoginDialog *_login_Dlg;
     RegisterDialog *_reg_Dlg;
     ResetDialog *_reset_Dlg;
     ChatDialog *_chat_Dlg;
+    bool _loginFramed; // 是否已记录登录页首帧
 };
 #endif // MAINWINDOW_H
@@ -0,0 +1,20 @@
+#ifndef MESSAGEDATA_H
+#define MESSAGEDATA_H
+
+#include <QString>
+
+// 聊天消息数据结构
+struct MessageData {
+    qint64 id;          // 唯一ID（会话ID在高32位，会话内序号在低32位）
+    int chatId;         // 所属会话
+    bool outgoing;      // 是否为自己发出
+    QString text;       // 消息文本
+    qint64 timeMs;      // 发送时间（毫秒时间戳）
+
+    MessageData(qint64 _id = 0, int _chatId = 0, bool _outgoing = false,
+                const QString &_text = "", qint64 _timeMs = 0)
+        : id(_id), chatId(_chatId), outgoing(_outgoing), text(_text), timeMs(_timeMs)
+    {}
+};
+
+#endif // MESSAGEDATA_H
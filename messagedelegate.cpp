@@ -0,0 +1,70 @@
+#include "messagedelegate.h"
+#include "messagemodel.h"
+#include "thememgr.h"
+
+#include <QAbstractItemView>
+#include <QPainter>
+#include <QtMath>
+
+MessageDelegate::MessageDelegate(QAbstractItemView *view)
+    : QStyledItemDelegate(view), m_view(view), m_layouts(MAX_LAYOUTS), m_hits(0), m_misses(0)
+{
+}
+
+int MessageDelegate::maxTextWidth() const
+{
+    // 气泡最多占视图宽度的三分之二
+    return qMax(40, m_view->viewport()->width() * 2 / 3 - 2 * BUBBLE_PADDING);
+}
+
+const MessageDelegate::Layout *MessageDelegate::layoutFor(const QModelIndex &index, const QFont &font) const
+{
+    const int width = maxTextWidth();
+    const QPair<qint64, int> key(index.data(MessageModel::IdRole).toLongLong(), width);
+    if (Layout *cached = m_layouts.object(key)) {
+        ++m_hits;
+        return cached;
+    }
+    ++m_misses;
+
+    Layout *layout = new Layout;
+    layout->text.setText(index.data(Qt::DisplayRole).toString());
+    layout->text.setTextFormat(Qt::PlainText);
+    layout->text.setTextWidth(width);
+    layout->text.prepare(QTransform(), font);
+    // 单行短消息按实际宽度收窄气泡
+    const QSizeF size = layout->text.size();
+    layout->textSize = QSize(qCeil(size.width()), qCeil(size.height()));
+    m_layouts.insert(key, layout);
+    return layout;
+}
+
+QSize MessageDelegate::sizeHint(const QStyleOptionViewItem &option, const QModelIndex &index) const
+{
+    const Layout *layout = layoutFor(index, option.font);
+    return QSize(m_view->viewport()->width(), layout->textSize.height() + 2 * BUBBLE_PADDING + 2 * ROW_SPACING);
+}
+
+void MessageDelegate::paint(QPainter *painter, const QStyleOptionViewItem &option, const QModelIndex &index) const
+{
+    const Layout *layout = layoutFor(index, option.font);
+    const bool outgoing = index.data(MessageModel::OutgoingRole).toBool();
+
+    // 自己的消息靠右，对方的消息靠左
+    const QSize bubbleSize = layout->textSize + QSize(2 * BUBBLE_PADDING, 2 * BUBBLE_PADDING);
+    const int x = outgoing ? option.rect.right() - BUBBLE_MARGIN - bubbleSize.width()
+                           : option.rect.left() + BUBBLE_MARGIN;
+    const QRect bubble(QPoint(x, option.rect.top() + ROW_SPACING), bubbleSize);
+
+    painter->save();
+    painter->setRenderHint(QPainter::Antialiasing);
+    painter->setPen(Qt::NoPen);
+    const ThemeColors &colors = ThemeMgr::GetInstance()->colors();
+    painter->setBrush(outgoing ? colors.accent : colors.bubbleIn);
+    painter->drawRoundedRect(bubble, BUBBLE_RADIUS, BUBBLE_RADIUS);
+
+    painter->setFont(option.font);
+    painter->setPen(outgoing ? colors.accentText : colors.bubbleInText);
+    painter->drawStaticText(bubble.topLeft() + QPoint(BUBBLE_PADDING, BUBBLE_PADDING), layout->text);
+    painter->restore();
+}
@@ -0,0 +1,52 @@
+#ifndef MESSAGEDELEGATE_H
+#define MESSAGEDELEGATE_H
+
+#include <QStyledItemDelegate>
+#include <QStaticText>
+#include <QCache>
+
+class QAbstractItemView;
+
+/**
+ * @brief 消息气泡委托
+ * 每条消息的排版结果（QStaticText和尺寸）按消息ID和视图宽度缓存，
+ * 计算行高和绘制共用同一份排版，滚动时不再重复折行。
+ */
+class MessageDelegate : public QStyledItemDelegate
+{
+    Q_OBJECT
+public:
+    explicit MessageDelegate(QAbstractItemView *view);
+
+    void paint(QPainter *painter, const QStyleOptionViewItem &option, const QModelIndex &index) const override;
+    QSize sizeHint(const QStyleOptionViewItem &option, const QModelIndex &index) const override;
+
+    // 模型重置或字体变化时清空排版缓存
+    void clearCache() { m_layouts.clear(); }
+    int hits() const { return m_hits; }
+    int misses() const { return m_misses; }
+
+private:
+    struct Layout {
+        QStaticText text;   // 已折行的文本
+        QSize textSize;     // 文本尺寸
+    };
+
+    // 取排版结果，没有则按当前宽度排版并缓存
+    const Layout *layoutFor(const QModelIndex &index, const QFont &font) const;
+    // 气泡内文本的最大宽度
+    int maxTextWidth() const;
+
+    QAbstractItemView *m_view;
+    mutable QCache<QPair<qint64, int>, Layout> m_layouts; // (消息ID, 视图宽度) -> 排版
+    mutable int m_hits;
+    mutable int m_misses;
+
+    static const int MAX_LAYOUTS = 2000;    // 排版缓存条数
+    static const int BUBBLE_PADDING = 10;   // 气泡内边距
+    static const int BUBBLE_MARGIN = 16;    // 气泡到视图边缘的距离
+    static const int ROW_SPACING = 6;       // 相邻消息的上下间距
+    static const int BUBBLE_RADIUS = 6;     // 气泡圆角
+};
+
+#endif // MESSAGEDELEGATE_H
@@ -0,0 +1,130 @@
+#include "messagelistview.h"
+#include "messagemodel.h"
+#include "messagedelegate.h"
+
+#include <QScrollBar>
+#include <QDebug>
+
+MessageListView::MessageListView(QWidget *parent)
+    : QListView(parent), m_loading(false), m_frames(0)
+{
+    m_model = new MessageModel(this);
+    m_delegate = new MessageDelegate(this);
+    setModel(m_model);
+    setItemDelegate(m_delegate);
+    // 行高各不相同，按像素滚动；宽度变化时重新排版
+    setUniformItemSizes(false);
+    setVerticalScrollMode(QAbstractItemView::ScrollPerPixel);
+    setResizeMode(QListView::Adjust);
+    setSelectionMode(QAbstractItemView::NoSelection);
+    setHorizontalScrollBarPolicy(Qt::ScrollBarAlwaysOff);
+    verticalScrollBar()->setSingleStep(20);
+
+    connect(verticalScrollBar(), &QScrollBar::valueChanged, this, &MessageListView::onScrollBarValueChanged);
+    // 重新打开会话后消息ID可能对应不同的内容，排版缓存随模型重置一起清掉
+    connect(m_model, &QAbstractItemModel::modelReset, m_delegate, &MessageDelegate::clearCache);
+
+    m_fpsTimer = new QTimer(this);
+    m_fpsTimer->setInterval(1000);
+    connect(m_fpsTimer, &QTimer::timeout, this, &MessageListView::reportFrameRate);
+}
+
+void MessageListView::openConversation(int chatId)
+{
+    if (chatId == m_model->chatId())
+        return;
+    m_loading = true;
+    m_model->openConversation(chatId);
+    executeDelayedItemsLayout();
+    scrollToBottom();
+    m_loading = false;
+}
+
+int MessageListView::chatId() const
+{
+    return m_model->chatId();
+}
+
+void MessageListView::appendIncoming(const MessageData &message)
+{
+    if (message.chatId != m_model->chatId())
+        return;
+    QScrollBar *bar = verticalScrollBar();
+    const bool atBottom = message.outgoing || bar->value() >= bar->maximum() - FOLLOW_SLACK;
+
+    m_loading = true;
+    // 窗口满时会裁掉顶部的行，不在底部时以首个可见行为锚点保持位置
+    QPersistentModelIndex anchor = atBottom ? QPersistentModelIndex()
+                                            : QPersistentModelIndex(indexAt(QPoint(viewport()->width() / 2, 0)));
+    const int anchorTop = anchor.isValid() ? visualRect(anchor).top() : 0;
+
+    m_model->appendIncoming(message);
+
+    executeDelayedItemsLayout();
+    if (atBottom) {
+        scrollToBottom();
+    } else if (anchor.isValid()) {
+        bar->setValue(bar->value() + visualRect(anchor).top() - anchorTop);
+    }
+    m_loading = false;
+}
+
+void MessageListView::changeEvent(QEvent *event)
+{
+    if (event->type() == QEvent::FontChange)
+        m_delegate->clearCache();
+    QListView::changeEvent(event);
+}
+
+void MessageListView::paintEvent(QPaintEvent *event)
+{
+    QListView::paintEvent(event);
+    ++m_frames;
+}
+
+void MessageListView::onScrollBarValueChanged(int value)
+{
+    if (!m_fpsTimer->isActive())
+        m_fpsTimer->start();
+    if (m_loading)
+        return;
+
+    QScrollBar *bar = verticalScrollBar();
+    if (value < LOAD_THRESHOLD && m_model->canLoadOlder()) {
+        loadPage(true);
+    } else if (value > bar->maximum() - LOAD_THRESHOLD && m_model->canLoadNewer()) {
+        loadPage(false);
+    }
+}
+
+void MessageListView::loadPage(bool older)
+{
+    m_loading = true;
+    // 记住首个可见行及其位置，加载和裁剪后把它放回原处
+    QPersistentModelIndex anchor = indexAt(QPoint(viewport()->width() / 2, 0));
+    const int anchorTop = anchor.isValid() ? visualRect(anchor).top() : 0;
+
+    if (older)
+        m_model->loadOlder();
+    else
+        m_model->loadNewer();
+
+    executeDelayedItemsLayout();
+    if (anchor.isValid()) {
+        QScrollBar *bar = verticalScrollBar();
+        bar->setValue(bar->value() + visualRect(anchor).top() - anchorTop);
+    }
+    m_loading = false;
+}
+
+void MessageListView::reportFrameRate()
+{
+    if (m_frames == 0) {
+        m_fpsTimer->stop();
+        return;
+    }
+    qDebug() << "消息列表:" << m_frames << "帧/秒, 窗口" << m_model->rowCount() << "条(起点"
+             << m_model->windowBegin() << "/" << m_model->totalCount() << "), 排版缓存命中/未命中:"
+             << m_delegate->hits() << "/" << m_delegate->misses();
+    m_frames = 0;
+}
@@ -0,0 +1,49 @@
+#ifndef MESSAGELISTVIEW_H
+#define MESSAGELISTVIEW_H
+
+#include <QListView>
+#include <QTimer>
+#include "messagedata.h"
+
+class MessageModel;
+class MessageDelegate;
+
+/**
+ * @brief 消息历史视图
+ * 滚动接近顶部或底部时让模型加载相邻的一页，并以首个可见行为锚点保持画面不跳动
+ */
+class MessageListView : public QListView
+{
+    Q_OBJECT
+public:
+    explicit MessageListView(QWidget *parent = nullptr);
+
+    // 打开会话并滚动到最新消息
+    void openConversation(int chatId);
+    int chatId() const;
+    // 收到当前会话的新消息：停在底部时跟随滚动，否则保持画面不动；自己发出的消息总是滚到底部
+    void appendIncoming(const MessageData &message);
+
+protected:
+    void paintEvent(QPaintEvent *event) override;
+    void changeEvent(QEvent *event) override;
+
+private slots:
+    void onScrollBarValueChanged(int value);
+    void reportFrameRate(); // 输出每秒绘制帧数
+
+private:
+    // 加载一页，前后保持锚点行在视口中的位置不变
+    void loadPage(bool older);
+
+    MessageModel *m_model;
+    MessageDelegate *m_delegate;
+    bool m_loading; // 正在加载页，忽略由此引起的滚动
+    QTimer *m_fpsTimer; // 帧率统计定时器
+    int m_frames; // 当前统计窗口内的绘制次数
+
+    static const int LOAD_THRESHOLD = 600; // 距边缘多少像素时加载下一页
+    static const int FOLLOW_SLACK = 20; // 距底部多少像素内视为停在底部
+};
+
+#endif // MESSAGELISTVIEW_H
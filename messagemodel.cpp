@@ -0,0 +1,120 @@
+#include "messagemodel.h"
+#include "messagestore.h"
+
+MessageModel::MessageModel(QObject *parent)
+    : QAbstractListModel(parent), m_chatId(-1), m_total(0), m_windowBegin(0)
+{
+}
+
+void MessageModel::openConversation(int chatId)
+{
+    beginResetModel();
+    m_chatId = chatId;
+    m_total = MessageStore::GetInstance()->messageCount(chatId);
+    m_windowBegin = qMax(0, m_total - PAGE_SIZE);
+    m_rows = MessageStore::GetInstance()->fetch(chatId, m_windowBegin, PAGE_SIZE);
+    endResetModel();
+}
+
+int MessageModel::loadOlder()
+{
+    if (!canLoadOlder())
+        return 0;
+
+    const int begin = qMax(0, m_windowBegin - PAGE_SIZE);
+    const QVector<MessageData> page = MessageStore::GetInstance()->fetch(m_chatId, begin, m_windowBegin - begin);
+    if (page.isEmpty())
+        return 0;
+
+    beginInsertRows(QModelIndex(), 0, page.size() - 1);
+    m_rows = page + m_rows;
+    m_windowBegin = begin;
+    endInsertRows();
+
+    // 超出上限时裁掉底部（此时用户在顶部，底部不可见）
+    if (m_rows.size() > MAX_WINDOW) {
+        beginRemoveRows(QModelIndex(), MAX_WINDOW, m_rows.size() - 1);
+        m_rows.resize(MAX_WINDOW);
+        endRemoveRows();
+    }
+    return page.size();
+}
+
+int MessageModel::loadNewer()
+{
+    if (!canLoadNewer())
+        return 0;
+
+    const QVector<MessageData> page = MessageStore::GetInstance()->fetch(
+        m_chatId, m_windowBegin + m_rows.size(), PAGE_SIZE);
+    if (page.isEmpty())
+        return 0;
+
+    beginInsertRows(QModelIndex(), m_rows.size(), m_rows.size() + page.size() - 1);
+    m_rows += page;
+    endInsertRows();
+
+    // 超出上限时裁掉顶部
+    if (m_rows.size() > MAX_WINDOW) {
+        const int excess = m_rows.size() - MAX_WINDOW;
+        beginRemoveRows(QModelIndex(), 0, excess - 1);
+        m_rows.remove(0, excess);
+        m_windowBegin += excess;
+        endRemoveRows();
+    }
+    return page.size();
+}
+
+// 窗口停在最新一页时直接接到末尾，否则只增加总数，滚到底部时再按页加载
+void MessageModel::appendIncoming(const MessageData &message)
+{
+    if (message.chatId != m_chatId)
+        return;
+    const int seq = int(quint32(message.id));
+    if (seq != m_total) {
+        // 序号对不上（之前的消息没有经过本模型追加），重新打开
+        openConversation(m_chatId);
+        return;
+    }
+    m_total = seq + 1;
+    if (m_windowBegin + m_rows.size() != seq)
+        return;
+
+    beginInsertRows(QModelIndex(), m_rows.size(), m_rows.size());
+    m_rows.append(message);
+    endInsertRows();
+
+    // 超出上限时裁掉顶部
+    if (m_rows.size() > MAX_WINDOW) {
+        const int excess = m_rows.size() - MAX_WINDOW;
+        beginRemoveRows(QModelIndex(), 0, excess - 1);
+        m_rows.remove(0, excess);
+        m_windowBegin += excess;
+        endRemoveRows();
+    }
+}
+
+int MessageModel::rowCount(const QModelIndex &parent) const
+{
+    return parent.isValid() ? 0 : m_rows.size();
+}
+
+QVariant MessageModel::data(const QModelIndex &index, int role) const
+{
+    if (!index.isValid() || index.row() < 0 || index.row() >= m_rows.size())
+        return QVariant();
+
+    const MessageData &message = m_rows[index.row()];
+    switch (role) {
+    case Qt::DisplayRole:
+        return message.text;
+    case IdRole:
+        return message.id;
+    case OutgoingRole:
+        return message.outgoing;
+    case TimeRole:
+        return message.timeMs;
+    default:
+        return QVariant();
+    }
+}
@@ -0,0 +1,55 @@
+#ifndef MESSAGEMODEL_H
+#define MESSAGEMODEL_H
+
+#include <QAbstractListModel>
+#include <QVector>
+#include "messagedata.h"
+
+/**
+ * @brief 消息列表模型
+ * 只持有当前会话中一段连续的消息窗口，向上/向下滚动时按页加载，
+ * 窗口超过上限时从另一端裁掉，内存与翻过的历史长度无关。
+ */
+class MessageModel : public QAbstractListModel
+{
+    Q_OBJECT
+public:
+    enum MessageRoles {
+        IdRole = Qt::UserRole + 1,  // 消息ID
+        OutgoingRole,               // 是否为自己发出
+        TimeRole                    // 发送时间（毫秒时间戳）
+    };
+
+    explicit MessageModel(QObject *parent = nullptr);
+
+    // 打开会话并加载最新的一页
+    void openConversation(int chatId);
+    int chatId() const { return m_chatId; }
+    // 会话消息总数
+    int totalCount() const { return m_total; }
+    // 窗口第一行在会话中的序号
+    int windowBegin() const { return m_windowBegin; }
+
+    bool canLoadOlder() const { return m_windowBegin > 0; }
+    bool canLoadNewer() const { return m_windowBegin + m_rows.size() < m_total; }
+    // 在顶部插入更早的一页，返回插入的行数
+    int loadOlder();
+    // 在底部追加更新的一页，返回追加的行数
+    int loadNewer();
+    // 追加一条新收到的消息（已写入消息存储），不是当前会话时忽略
+    void appendIncoming(const MessageData &message);
+
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+
+    static const int PAGE_SIZE = 100;   // 每页消息数
+    static const int MAX_WINDOW = 500;  // 窗口最多保留的消息数
+
+private:
+    int m_chatId;
+    int m_total;
+    int m_windowBegin;
+    QVector<MessageData> m_rows;
+};
+
+#endif // MESSAGEMODEL_H
@@ -0,0 +1,46 @@
+#include "messagestore.h"
+#include "localdb.h"
+
+MessageStore::MessageStore()
+{
+}
+
+MessageStore::~MessageStore()
+{
+}
+
+int MessageStore::messageCount(int chatId) const
+{
+    const QPair<int, int> stored = storedRange(chatId);
+    return stored.second - stored.first;
+}
+
+QPair<int, int> MessageStore::storedRange(int chatId) const
+{
+    auto it = _storedRanges.constFind(chatId);
+    if (it == _storedRanges.constEnd())
+        it = _storedRanges.insert(chatId, LocalDb::GetInstance()->messageRange(chatId));
+    return it.value();
+}
+
+// 旧版本的库里序号可能不从0开始，下标按最小序号偏移
+QVector<MessageData> MessageStore::fetch(int chatId, int begin, int count) const
+{
+    const QPair<int, int> stored = storedRange(chatId);
+    begin = qMax(0, begin);
+    const int end = qMin(stored.second - stored.first, begin + qMax(0, count));
+    if (begin >= end)
+        return QVector<MessageData>();
+    return LocalDb::GetInstance()->fetchMessages(chatId, stored.first + begin, end - begin);
+}
+
+// 序号接在已落盘的消息之后，与已有消息的ID不会重复
+MessageData MessageStore::appendMessage(int chatId, bool outgoing, const QString &text, qint64 timeMs)
+{
+    const QPair<int, int> stored = storedRange(chatId);
+    const int seq = stored.second;
+    MessageData message((qint64(chatId) << 32) | quint32(seq), chatId, outgoing, text, timeMs);
+    _storedRanges.insert(chatId, qMakePair(stored.first, seq + 1));
+    LocalDb::GetInstance()->enqueueMessage(message);
+    return message;
+}
@@ -0,0 +1,37 @@
+#ifndef MESSAGESTORE_H
+#define MESSAGESTORE_H
+#include <QObject>
+#include <QVector>
+#include <QHash>
+#include <QPair>
+#include "singleton.h"
+#include "messagedata.h"
+
+/**
+ * @brief 分页消息存储
+ * 按会话和下标范围从本地数据库分页取消息，下标0为最早的一条；没有消息的会话条数为0。
+ * 新消息接在已落盘的消息之后编号，经写后队列落盘。
+ */
+class MessageStore : public QObject, public Singleton<MessageStore>,
+                     public std::enable_shared_from_this<MessageStore>
+{
+    Q_OBJECT
+public:
+    friend class Singleton<MessageStore>;
+    ~MessageStore();
+    // 会话的消息总数
+    int messageCount(int chatId) const;
+    // 取下标[begin, begin + count)范围内的消息，超出范围的部分被截掉
+    QVector<MessageData> fetch(int chatId, int begin, int count) const;
+    // 追加一条新消息（序号由存储分配），经写后队列落盘
+    MessageData appendMessage(int chatId, bool outgoing, const QString &text, qint64 timeMs);
+
+private:
+    MessageStore();
+    // 已落盘消息的序号范围[first, end)，end为0表示没有（首次查询后缓存）
+    QPair<int, int> storedRange(int chatId) const;
+
+    mutable QHash<int, QPair<int, int>> _storedRanges; // 会话 -> 已落盘序号范围
+};
+
+#endif // MESSAGESTORE_H
@@ -0,0 +1,77 @@
+#ifndef MSGDISPATCHER_H
+#define MSGDISPATCHER_H
+#include <QByteArray>
+#include <QString>
+#include <array>
+#include <type_traits>
+#include "jsonschema.h"
+
+// 从处理函数的成员指针类型推出它接收的报文结构体
+template <typename Handler>
+struct MsgHandlerTraits;
+
+template <typename Owner, typename Payload>
+struct MsgHandlerTraits<void (Owner::*)(const Payload &)> {
+    using OwnerType = Owner;
+    using PayloadType = Payload;
+};
+
+/**
+ * @brief 报文分发表
+ * 以消息ID减去FIRST_ID为下标的定长数组，每格是一个在注册时按处理函数实例化的跳板：
+ * 解码报文体到处理函数声明的结构体，校验通过后直接调用成员函数。
+ * 分发是一次下标访问加一次函数指针调用，报文体按引用传递。
+ * 用法：dispatcher.on<ID_XXX, &Owner::onXxx>()，ID越界在编译期报错。
+ */
+template <typename Owner, int FIRST_ID, int LAST_ID>
+class MsgDispatcher
+{
+public:
+    enum Result {
+        Handled,        // 已交给处理函数
+        Unregistered,   // 没有注册该ID
+        DecodeFailed    // 报文体不符合结构体的字段描述
+    };
+
+    explicit MsgDispatcher(Owner *owner) : _owner(owner)
+    {
+        _table.fill(nullptr);
+    }
+
+    template <int ID, auto Handler>
+    void on()
+    {
+        static_assert(ID >= FIRST_ID && ID <= LAST_ID, "消息ID超出分发表范围");
+        static_assert(std::is_same_v<typename MsgHandlerTraits<decltype(Handler)>::OwnerType, Owner>,
+                      "处理函数必须是Owner的成员函数");
+        _table[ID - FIRST_ID] = &invoke<Handler>;
+    }
+
+    // 解码失败时error给出字段和原因
+    Result dispatch(int id, const QByteArray &body, QString &error) const
+    {
+        const int index = id - FIRST_ID;
+        if (index < 0 || index >= SIZE || !_table[index])
+            return Unregistered;
+        return _table[index](_owner, body, error) ? Handled : DecodeFailed;
+    }
+
+private:
+    using Thunk = bool (*)(Owner *, const QByteArray &, QString &);
+
+    template <auto Handler>
+    static bool invoke(Owner *owner, const QByteArray &body, QString &error)
+    {
+        typename MsgHandlerTraits<decltype(Handler)>::PayloadType payload;
+        if (!decodeJson(body, payload, error))
+            return false;
+        (owner->*Handler)(payload);
+        return true;
+    }
+
+    static const int SIZE = LAST_ID - FIRST_ID + 1;
+    Owner *_owner;
+    std::array<Thunk, SIZE> _table;
+};
+
+#endif // MSGDISPATCHER_H
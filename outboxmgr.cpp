@@ -0,0 +1,313 @@
+#include "outboxmgr.h"
+#include "tcpmgr.h"
+#include <QCoreApplication>
+#include <QDir>
+#include <QSaveFile>
+#include <QStandardPaths>
+#include <QJsonObject>
+#include <QDebug>
+#ifdef Q_OS_WIN
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+OutboxMgr::OutboxMgr() : _uid(-1), _inFlight(0), _nextId(1), _durableId(0), _ackedId(0), _unsynced(0),
+    _ready(false), _writeFailed(false), _compactedSize(0), _syncs(0), _syncedRecords(0), _compactions(0)
+{
+    _syncTimer.setSingleShot(true);
+    _syncTimer.setInterval(SYNC_INTERVAL);
+    connect(&_syncTimer, &QTimer::timeout, this, &OutboxMgr::syncLog);
+    // 退出前把未同步的记录落盘
+    connect(qApp, &QCoreApplication::aboutToQuit, this, &OutboxMgr::syncLog);
+}
+
+OutboxMgr::~OutboxMgr()
+{
+    close();
+}
+
+bool OutboxMgr::open(int uid)
+{
+    if (uid == _uid && _log.isOpen())
+        return true;
+    close();
+
+    const QString dir = QStandardPaths::writableLocation(QStandardPaths::AppDataLocation);
+    QDir().mkpath(dir);
+    _log.setFileName(QDir(dir).filePath(QString("outbox_%1.log").arg(uid)));
+    if (!_log.open(QIODevice::ReadWrite)) {
+        qDebug() << "发件箱日志打开失败:" << _log.errorString();
+        return false;
+    }
+    _uid = uid;
+    _pending.clear();
+    _inFlight = 0;
+    _nextId = 1;
+    _ackedId = 0;
+    _unsynced = 0;
+    _writeFailed = false;
+    _compactedSize = 0;
+    _stream.setDevice(&_log);
+    _stream.setVersion(QDataStream::Qt_6_9);
+    load();
+    // 从文件读出的记录视为已落盘
+    _durableId = _nextId - 1;
+    if (needsCompaction())
+        compact();
+    qDebug() << "发件箱: 未确认" << _pending.size() << "条, 下一个id" << _nextId;
+    return true;
+}
+
+void OutboxMgr::close()
+{
+    if (!_log.isOpen())
+        return;
+    _ready = false; // 落盘时不再发出，避免换用户后把旧消息发到新会话上
+    syncLog();
+    _stream.setDevice(nullptr);
+    _log.close();
+    _uid = -1;
+}
+
+bool OutboxMgr::load()
+{
+    if (_log.size() == 0) {
+        _stream << MAGIC << VERSION;
+        return true;
+    }
+
+    quint32 magic = 0;
+    quint16 version = 0;
+    _stream >> magic >> version;
+    if (magic != MAGIC || version != VERSION) {
+        qDebug() << "发件箱日志格式不对，重建:" << _log.fileName();
+        _log.resize(0);
+        _log.seek(0);
+        _stream.resetStatus();
+        _stream << MAGIC << VERSION;
+        return false;
+    }
+
+    qint64 goodPos = _log.pos();
+    while (!_stream.atEnd()) {
+        quint8 type = 0;
+        _stream >> type;
+        if (type == REC_BASE) {
+            qint64 nextId = 0;
+            _stream >> nextId;
+            if (_stream.status() != QDataStream::Ok)
+                break;
+            _nextId = qMax(_nextId, nextId);
+        } else if (type == REC_SEND) {
+            OutboxEntry entry;
+            qint32 chatId = 0;
+            _stream >> entry.id >> chatId >> entry.timeMs >> entry.text;
+            if (_stream.status() != QDataStream::Ok)
+                break;
+            entry.chatId = chatId;
+            _nextId = qMax(_nextId, entry.id + 1);
+            if (entry.id > _ackedId)
+                _pending.enqueue(entry);
+        } else if (type == REC_ACK) {
+            qint64 ackId = 0;
+            _stream >> ackId;
+            if (_stream.status() != QDataStream::Ok)
+                break;
+            _ackedId = qMax(_ackedId, ackId);
+            while (!_pending.isEmpty() && _pending.head().id <= _ackedId) {
+                _pending.dequeue();
+            }
+        } else {
+            break;
+        }
+        goodPos = _log.pos();
+    }
+
+    // 崩溃时最后一条记录可能只写了一半，截掉后从这里继续追加
+    if (goodPos < _log.size()) {
+        qDebug() << "发件箱日志末尾有" << _log.size() - goodPos << "字节不完整的记录，已截掉";
+        _log.resize(goodPos);
+    }
+    _log.seek(goodPos);
+    _stream.resetStatus();
+    return true;
+}
+
+qint64 OutboxMgr::enqueue(int chatId, const QString &text, qint64 timeMs)
+{
+    // 日志写坏后不再接受新消息，直到重写成功
+    if (!_log.isOpen() || _writeFailed || _pending.size() >= MAX_PENDING)
+        return -1;
+
+    OutboxEntry entry = {_nextId, chatId, timeMs, text};
+    writeSend(_stream, entry);
+    if (_stream.status() != QDataStream::Ok) {
+        markWriteFailed();
+        return -1;
+    }
+    ++_nextId;
+    _pending.enqueue(entry);
+    if (++_unsynced >= SYNC_BATCH)
+        syncLog();
+    else if (!_syncTimer.isActive())
+        _syncTimer.start(SYNC_INTERVAL);
+    return entry.id;
+}
+
+void OutboxMgr::writeSend(QDataStream &out, const OutboxEntry &entry)
+{
+    out << quint8(REC_SEND) << entry.id << qint32(entry.chatId) << entry.timeMs << entry.text;
+}
+
+// 写入、flush或fsync失败：日志末尾可能有写了一半的记录，不能再往后追加。
+// 已落盘水位不动，之后的消息不发出，定时重试把未确认的消息整体重写一遍
+void OutboxMgr::markWriteFailed()
+{
+    qDebug() << "发件箱日志写入失败，暂停发送:" << _log.errorString();
+    _stream.resetStatus();
+    _writeFailed = true;
+    _syncTimer.start(SYNC_RETRY_INTERVAL);
+}
+
+// 一批记录一次fsync，之后这批消息才允许发出
+void OutboxMgr::syncLog()
+{
+    _syncTimer.stop();
+    if (!_log.isOpen())
+        return;
+    if (_writeFailed) {
+        if (!compact())
+            _syncTimer.start(SYNC_RETRY_INTERVAL);
+        return;
+    }
+    if (_unsynced == 0)
+        return;
+#ifdef Q_OS_WIN
+    const bool synced = _log.flush() && _commit(_log.handle()) == 0;
+#else
+    const bool synced = _log.flush() && ::fsync(_log.handle()) == 0;
+#endif
+    if (!synced) {
+        markWriteFailed();
+        return;
+    }
+    ++_syncs;
+    _syncedRecords += _unsynced;
+    _unsynced = 0;
+    _durableId = _nextId - 1;
+    pump();
+    return true;
+}
+
+void OutboxMgr::pump()
+{
+    if (!_ready)
+        return;
+    while (_inFlight < _pending.size() && _inFlight < SEND_WINDOW) {
+        const OutboxEntry &entry = _pending.at(_inFlight);
+        if (entry.id > _durableId)
+            break;
+        QJsonObject jsonObj;
+        jsonObj["id"] = entry.id;
+        jsonObj["chat"] = entry.chatId;
+        jsonObj["text"] = entry.text;
+        jsonObj["t"] = entry.timeMs;
+        TcpMgr::GetInstance()->sendJsonData(ReqId::ID_SEND_CHAT_MSG, jsonObj);
+        ++_inFlight;
+    }
+}
+
+void OutboxMgr::resume()
+{
+    _ready = true;
+    _inFlight = 0;
+    if (!_pending.isEmpty())
+        qDebug() << "发件箱: 从id" << _pending.head().id << "开始重发" << _pending.size() << "条";
+    pump();
+    return true;
+}
+
+void OutboxMgr::suspend()
+{
+    _ready = false;
+    _inFlight = 0;
+}
+
+// 确认记录不单独fsync：丢了只会让重连后多重发几条，服务器按id去重
+void OutboxMgr::acknowledge(qint64 ackId)
+{
+    if (ackId <= _ackedId || !_log.isOpen())
+        return;
+    _ackedId = ackId;
+    int acked = 0;
+    while (!_pending.isEmpty() && _pending.head().id <= ackId) {
+        _pending.dequeue();
+        ++acked;
+    }
+    _inFlight = qMax(0, _inFlight - acked);
+    _stream << quint8(REC_ACK) << ackId;
+    if (_stream.status() != QDataStream::Ok) {
+        markWriteFailed(); // 确认记录丢了只会多重发，但写了一半的记录会挡住后面的追加
+        return;
+    }
+
+    if (needsCompaction())
+        compact();
+    pump();
+    return true;
+}
+
+// 日志超过下限且比上次压缩后的大小翻倍时才压缩：未确认的消息本身很多时，
+// 不至于每次确认都把整个文件重写一遍。只追加不改写，pos即文件长度（不触发flush）
+bool OutboxMgr::needsCompaction() const
+{
+    const qint64 size = _log.pos();
+    return size > COMPACT_BYTES && size > _compactedSize * COMPACT_GROWTH;
+}
+
+// 重写成"下一个id + 未确认消息"，QSaveFile提交时fsync并原子替换；
+// 写入失败后也靠它恢复，成功后所有未确认的消息都已落盘
+bool OutboxMgr::compact()
+{
+    QSaveFile file(_log.fileName());
+    if (!file.open(QIODevice::WriteOnly)) {
+        qDebug() << "发件箱压缩失败:" << file.errorString();
+        return false;
+    }
+    QDataStream out(&file);
+    out.setVersion(QDataStream::Qt_6_9);
+    out << MAGIC << VERSION << quint8(REC_BASE) << _nextId;
+    for (const OutboxEntry &entry : std::as_const(_pending)) {
+        writeSend(out, entry);
+    }
+
+    // Windows下不能替换打开着的文件，先关掉旧日志
+    const qint64 oldSize = _log.pos();
+    const bool flushed = _log.flush();
+    _stream.setDevice(nullptr);
+    _log.close();
+    const bool committed = file.commit();
+    if (!_log.open(QIODevice::ReadWrite | QIODevice::Append)) {
+        qDebug() << "发件箱日志重新打开失败:" << _log.errorString();
+        return false;
+    }
+    _stream.setDevice(&_log);
+    if (!committed) {
+        // 旧日志原样保留，其中未fsync的记录仍等下一次同步后才能发出；
+        // 按当前大小记为压缩基准，等日志再翻倍时重试
+        qDebug() << "发件箱压缩提交失败，继续使用旧日志:" << file.errorString();
+        _compactedSize = oldSize;
+        if (!flushed)
+            markWriteFailed(); // 缓冲的记录没写进旧日志，只能等重写成功
+        return false;
+    }
+    _compactedSize = _log.size();
+    _writeFailed = false;
+    _unsynced = 0;
+    _durableId = _nextId - 1;
+    ++_compactions;
+    qDebug() << "发件箱压缩:" << oldSize << "->" << _log.size() << "字节, 未确认" << _pending.size() << "条";
+    pump();
+    return true;
+}
@@ -0,0 +1,99 @@
+#ifndef OUTBOXMGR_H
+#define OUTBOXMGR_H
+#include <QObject>
+#include <QFile>
+#include <QDataStream>
+#include <QQueue>
+#include <QTimer>
+#include "singleton.h"
+
+/**
+ * @brief 发件箱
+ * 待发消息先追加到本地日志（每个用户一个文件），再按客户端生成的递增id依次发送，
+ * 服务器按id累计确认后出队；断线重连后从第一条未确认的消息开始重发（至少一次，服务器按id去重）。
+ * 日志攒批fsync：每SYNC_BATCH条或SYNC_INTERVAL毫秒同步一次，消息只有落盘后才会发出，
+ * 进程崩溃也不会丢已接受的消息。内存里最多保留MAX_PENDING条未确认消息，在途最多SEND_WINDOW条。
+ * 日志格式（大端）：文件头"BJOB" | quint16 版本，之后是记录：
+ *   REC_BASE  qint64 下一个id（压缩后写在开头，保证id不回退）
+ *   REC_SEND  qint64 id | qint32 会话 | qint64 时间毫秒 | QString 内容
+ *   REC_ACK   qint64 已确认到的id
+ */
+class OutboxMgr : public QObject, public Singleton<OutboxMgr>,
+                  public std::enable_shared_from_this<OutboxMgr>
+{
+    Q_OBJECT
+public:
+    friend class Singleton<OutboxMgr>;
+    ~OutboxMgr();
+
+    // 打开用户的发件箱日志并读出未确认的消息，聊天登录成功后调用
+    bool open(int uid);
+    // 追加一条待发消息，返回客户端消息id；未打开或已满时返回-1
+    qint64 enqueue(int chatId, const QString &text, qint64 timeMs);
+    // 会话就绪：从第一条未确认的消息开始按序发送
+    void resume();
+    // 连接断开：在途的消息视为未发出，重连后重发
+    void suspend();
+    // 服务器确认ackId及之前的消息
+    void acknowledge(qint64 ackId);
+    int pendingCount() const { return _pending.size(); }
+    // 累计的fsync次数、fsync覆盖的记录数和压缩次数
+    qint64 syncCount() const { return _syncs; }
+    qint64 syncedRecordCount() const { return _syncedRecords; }
+    int compactionCount() const { return _compactions; }
+
+private:
+    OutboxMgr();
+
+    struct OutboxEntry {
+        qint64 id;
+        int chatId;
+        qint64 timeMs;
+        QString text;
+    };
+
+    enum RecordType : quint8 {
+        REC_BASE = 0,
+        REC_SEND = 1,
+        REC_ACK = 2,
+    };
+
+    bool load();            // 读日志重建未确认队列，截掉末尾写了一半的记录
+    void close();
+    static void writeSend(QDataStream &out, const OutboxEntry &entry);
+    void syncLog();         // flush并fsync，推进已落盘水位后继续发送
+    void pump();            // 在窗口内发送已落盘、未发出的消息
+    bool needsCompaction() const;
+    bool compact();         // 只保留未确认的消息重写日志，成功返回true
+    void markWriteFailed(); // 日志写坏：暂停发送并定时重写
+
+    int _uid;               // 日志所属用户，-1为未打开
+    QFile _log;
+    QDataStream _stream;
+    QQueue<OutboxEntry> _pending; // 未确认的消息，id递增
+    int _inFlight;          // _pending前_inFlight条已发出、等待确认
+    qint64 _nextId;         // 下一个消息id
+    qint64 _durableId;      // 已fsync的最大id，之后的消息还不能发
+    qint64 _ackedId;        // 已确认到的id
+    int _unsynced;          // 上次fsync之后写入的记录数
+    bool _ready;            // 聊天会话已就绪
+    bool _writeFailed;      // 写入或同步失败过，日志末尾不可信，重写成功前不再追加
+    qint64 _compactedSize;  // 上次压缩后的日志大小
+    QTimer _syncTimer;
+
+    qint64 _syncs;          // fsync次数
+    qint64 _syncedRecords;  // fsync覆盖的记录数
+    int _compactions;       // 压缩次数
+
+    static const quint32 MAGIC = 0x424A4F42; // "BJOB"
+    static const quint16 VERSION = 1;
+    static const int MAX_PENDING = 10000;   // 内存中未确认消息上限
+    static const int SEND_WINDOW = 256;     // 在途（已发未确认）上限
+    static const int SYNC_BATCH = 128;      // 攒够这么多条立即fsync
+    static const int SYNC_INTERVAL = 10;    // 否则最多等这么久（毫秒）
+    static const int SYNC_RETRY_INTERVAL = 1000; // 写入失败后重试重写的间隔（毫秒）
+    static const qint64 COMPACT_BYTES = 1 << 20; // 日志至少超过1MB才压缩
+    static const int COMPACT_GROWTH = 2;    // 且超过上次压缩后大小的倍数
+};
+
+#endif // OUTBOXMGR_H
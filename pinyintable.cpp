@@ -0,0 +1,426 @@
+#include "pinyintable.h"
+#include <algorithm>
+#include <cstring>
+
+namespace {
+
+struct PinyinEntry {
+    char16_t ch;            // 汉字码点
+    const char *readings;   // 读音，多音字用“|”分隔
+};
+
+// 按码点升序排列，新增时保持有序
+const PinyinEntry PINYIN_TABLE[] = {
+    {0x4E00, "yi"}, // 一
+    {0x4E01, "ding"}, // 丁
+    {0x4E07, "wan"}, // 万
+    {0x4E1C, "dong"}, // 东
+    {0x4E1D, "si"}, // 丝
+    {0x4E25, "yan"}, // 严
+    {0x4E2D, "zhong"}, // 中
+    {0x4E3D, "li"}, // 丽
+    {0x4E50, "le|yue"}, // 乐
+    {0x4E86, "le|liao"}, // 了
+    {0x4E8E, "yu"}, // 于
+    {0x4E91, "yun"}, // 云
+    {0x4EA4, "jiao"}, // 交
+    {0x4EA7, "chan"}, // 产
+    {0x4EAE, "liang"}, // 亮
+    {0x4EB2, "qin|qing"}, // 亲
+    {0x4EBA, "ren"}, // 人
+    {0x4EC7, "qiu|chou"}, // 仇
+    {0x4EFB, "ren"}, // 任
+    {0x4F0D, "wu"}, // 伍
+    {0x4F1A, "hui|kuai"}, // 会
+    {0x4F1F, "wei"}, // 伟
+    {0x4F55, "he"}, // 何
+    {0x4F59, "yu"}, // 余
+    {0x4F5C, "zuo"}, // 作
+    {0x4F73, "jia"}, // 佳
+    {0x4FAF, "hou"}, // 侯
+    {0x4FCA, "jun"}, // 俊
+    {0x4FDE, "yu"}, // 俞
+    {0x4FF1, "ju"}, // 俱
+    {0x5029, "qian"}, // 倩
+    {0x502A, "ni"}, // 倪
+    {0x5065, "jian"}, // 健
+    {0x5085, "fu"}, // 傅
+    {0x5149, "guang"}, // 光
+    {0x516C, "gong"}, // 公
+    {0x5170, "lan"}, // 兰
+    {0x519B, "jun"}, // 军
+    {0x51AC, "dong"}, // 冬
+    {0x51AF, "feng"}, // 冯
+    {0x51E4, "feng"}, // 凤
+    {0x51EF, "kai"}, // 凯
+    {0x5218, "liu"}, // 刘
+    {0x521A, "gang"}, // 刚
+    {0x52A1, "wu"}, // 务
+    {0x52C7, "yong"}, // 勇
+    {0x5305, "bao"}, // 包
+    {0x5317, "bei"}, // 北
+    {0x533A, "ou|qu"}, // 区
+    {0x534E, "hua"}, // 华
+    {0x5355, "shan|dan|chan"}, // 单
+    {0x5357, "nan"}, // 南
+    {0x535A, "bo"}, // 博
+    {0x536B, "wei"}, // 卫
+    {0x53C2, "shen|can"}, // 参
+    {0x53CB, "you"}, // 友
+    {0x53D1, "fa"}, // 发
+    {0x53F2, "shi"}, // 史
+    {0x53F6, "ye|xie"}, // 叶
+    {0x53F8, "si"}, // 司
+    {0x540C, "tong"}, // 同
+    {0x5415, "lv"}, // 吕
+    {0x5434, "wu"}, // 吴
+    {0x5468, "zhou"}, // 周
+    {0x548C, "he|huo"}, // 和
+    {0x54C1, "pin"}, // 品
+    {0x54E5, "ge"}, // 哥
+    {0x5510, "tang"}, // 唐
+    {0x552E, "shou"}, // 售
+    {0x55BB, "yu"}, // 喻
+    {0x5609, "jia"}, // 嘉
+    {0x56E2, "tuan"}, // 团
+    {0x56FD, "guo"}, // 国
+    {0x573A, "chang"}, // 场
+    {0x5764, "kun"}, // 坤
+    {0x590F, "xia"}, // 夏
+    {0x5927, "da"}, // 大
+    {0x5929, "tian"}, // 天
+    {0x595A, "xi"}, // 奚
+    {0x597D, "hao"}, // 好
+    {0x5988, "ma"}, // 妈
+    {0x598D, "yan"}, // 妍
+    {0x59B9, "mei"}, // 妹
+    {0x59D0, "jie"}, // 姐
+    {0x59DA, "yao"}, // 姚
+    {0x59DC, "jiang"}, // 姜
+    {0x5A1C, "na"}, // 娜
+    {0x5A1F, "juan"}, // 娟
+    {0x5A77, "ting"}, // 婷
+    {0x5B50, "zi"}, // 子
+    {0x5B54, "kong"}, // 孔
+    {0x5B59, "sun"}, // 孙
+    {0x5B5F, "meng"}, // 孟
+    {0x5B63, "ji"}, // 季
+    {0x5B66, "xue"}, // 学
+    {0x5B81, "ning"}, // 宁
+    {0x5B87, "yu"}, // 宇
+    {0x5B89, "an"}, // 安
+    {0x5B8B, "song"}, // 宋
+    {0x5B8F, "hong"}, // 宏
+    {0x5BB6, "jia"}, // 家
+    {0x5C09, "yu|wei"}, // 尉
+    {0x5C0F, "xiao"}, // 小
+    {0x5C24, "you"}, // 尤
+    {0x5C39, "yin"}, // 尹
+    {0x5C48, "qu"}, // 屈
+    {0x5C55, "zhan"}, // 展
+    {0x5C91, "cen"}, // 岑
+    {0x5CF0, "feng"}, // 峰
+    {0x5D14, "cui"}, // 崔
+    {0x5DE5, "gong"}, // 工
+    {0x5E02, "shi"}, // 市
+    {0x5E05, "shuai"}, // 帅
+    {0x5E06, "fan"}, // 帆
+    {0x5E08, "shi"}, // 师
+    {0x5E38, "chang"}, // 常
+    {0x5E73, "ping"}, // 平
+    {0x5E9E, "pang"}, // 庞
+    {0x5EB7, "kang"}, // 康
+    {0x5EC9, "lian"}, // 廉
+    {0x5ED6, "liao"}, // 廖
+    {0x5EFA, "jian"}, // 建
+    {0x5F00, "kai"}, // 开
+    {0x5F1F, "di"}, // 弟
+    {0x5F20, "zhang"}, // 张
+    {0x5F3A, "qiang|jiang"}, // 强
+    {0x5F6D, "peng"}, // 彭
+    {0x5F90, "xu"}, // 徐
+    {0x5FB7, "de"}, // 德
+    {0x5FC3, "xin"}, // 心
+    {0x5FD7, "zhi"}, // 志
+    {0x5FEB, "kuai"}, // 快
+    {0x601D, "si"}, // 思
+    {0x6021, "yi"}, // 怡
+    {0x60A6, "yue"}, // 悦
+    {0x6167, "hui"}, // 慧
+    {0x620F, "xi"}, // 戏
+    {0x6210, "cheng"}, // 成
+    {0x621A, "qi"}, // 戚
+    {0x6234, "dai"}, // 戴
+    {0x6280, "ji"}, // 技
+    {0x632F, "zhen"}, // 振
+    {0x654F, "min"}, // 敏
+    {0x6587, "wen"}, // 文
+    {0x658C, "bin"}, // 斌
+    {0x65B0, "xin"}, // 新
+    {0x65B9, "fang"}, // 方
+    {0x65BD, "shi"}, // 施
+    {0x65ED, "xu"}, // 旭
+    {0x660C, "chang"}, // 昌
+    {0x660E, "ming"}, // 明
+    {0x6613, "yi"}, // 易
+    {0x6625, "chun"}, // 春
+    {0x6653, "xiao"}, // 晓
+    {0x6668, "chen"}, // 晨
+    {0x6676, "jing"}, // 晶
+    {0x66F9, "cao"}, // 曹
+    {0x66FE, "zeng|ceng"}, // 曾
+    {0x670B, "peng"}, // 朋
+    {0x672F, "shu"}, // 术
+    {0x6731, "zhu"}, // 朱
+    {0x6734, "piao|pu"}, // 朴
+    {0x674E, "li"}, // 李
+    {0x675C, "du"}, // 杜
+    {0x6768, "yang"}, // 杨
+    {0x6770, "jie"}, // 杰
+    {0x6797, "lin"}, // 林
+    {0x67CF, "bai|bo"}, // 柏
+    {0x67E5, "zha|cha"}, // 查
+    {0x67F3, "liu"}, // 柳
+    {0x6842, "gui"}, // 桂
+    {0x6881, "liang"}, // 梁
+    {0x6885, "mei"}, // 梅
+    {0x6893, "zi"}, // 梓
+    {0x68EE, "sen"}, // 森
+    {0x6B22, "huan"}, // 欢
+    {0x6B23, "xin"}, // 欣
+    {0x6B66, "wu"}, // 武
+    {0x6BB7, "yin"}, // 殷
+    {0x6BD5, "bi"}, // 毕
+    {0x6BDB, "mao"}, // 毛
+    {0x6C34, "shui"}, // 水
+    {0x6C38, "yong"}, // 永
+    {0x6C5F, "jiang"}, // 江
+    {0x6C64, "tang"}, // 汤
+    {0x6C6A, "wang"}, // 汪
+    {0x6C88, "shen"}, // 沈
+    {0x6CE2, "bo"}, // 波
+    {0x6CFD, "ze"}, // 泽
+    {0x6D0B, "yang"}, // 洋
+    {0x6D2A, "hong"}, // 洪
+    {0x6D41, "liu"}, // 流
+    {0x6D69, "hao"}, // 浩
+    {0x6D77, "hai"}, // 海
+    {0x6D9B, "tao"}, // 涛
+    {0x6DB5, "han"}, // 涵
+    {0x6E38, "you"}, // 游
+    {0x6F58, "pan"}, // 潘
+    {0x718A, "xiong"}, // 熊
+    {0x71D5, "yan"}, // 燕
+    {0x7238, "ba"}, // 爸
+    {0x72C4, "di"}, // 狄
+    {0x7389, "yu"}, // 玉
+    {0x738B, "wang"}, // 王
+    {0x73ED, "ban"}, // 班
+    {0x7433, "lin"}, // 琳
+    {0x7434, "qin"}, // 琴
+    {0x7530, "tian"}, // 田
+    {0x767D, "bai"}, // 白
+    {0x7684, "de|di"}, // 的
+    {0x76D6, "ge|gai"}, // 盖
+    {0x76EE, "mu"}, // 目
+    {0x777F, "rui"}, // 睿
+    {0x77F3, "shi|dan"}, // 石
+    {0x78CA, "lei"}, // 磊
+    {0x795D, "zhu"}, // 祝
+    {0x79C0, "xiu"}, // 秀
+    {0x79CB, "qiu"}, // 秋
+    {0x79E6, "qin"}, // 秦
+    {0x7A0B, "cheng"}, // 程
+    {0x7AA6, "dou"}, // 窦
+    {0x7ACB, "li"}, // 立
+    {0x7AE0, "zhang"}, // 章
+    {0x7C73, "mi"}, // 米
+    {0x7C89, "fen"}, // 粉
+    {0x7EA2, "hong"}, // 红
+    {0x7EA7, "ji"}, // 级
+    {0x7EAA, "ji"}, // 纪
+    {0x7EC4, "zu"}, // 组
+    {0x7F2A, "miao|mou"}, // 缪
+    {0x7F57, "luo"}, // 罗
+    {0x7FA4, "qun"}, // 群
+    {0x7FDF, "zhai|di"}, // 翟
+    {0x7FE0, "cui"}, // 翠
+    {0x8001, "lao"}, // 老
+    {0x804A, "liao"}, // 聊
+    {0x80E1, "hu"}, // 胡
+    {0x8212, "shu"}, // 舒
+    {0x8273, "yan"}, // 艳
+    {0x82B1, "hua"}, // 花
+    {0x82B3, "fang"}, // 芳
+    {0x82CF, "su"}, // 苏
+    {0x82D7, "miao"}, // 苗
+    {0x82F1, "ying"}, // 英
+    {0x8303, "fan"}, // 范
+    {0x8363, "rong"}, // 荣
+    {0x8389, "li"}, // 莉
+    {0x83CA, "ju"}, // 菊
+    {0x840D, "ping"}, // 萍
+    {0x8425, "ying"}, // 营
+    {0x8427, "xiao"}, // 萧
+    {0x845B, "ge"}, // 葛
+    {0x8463, "dong"}, // 董
+    {0x848B, "jiang"}, // 蒋
+    {0x84DD, "lan"}, // 蓝
+    {0x8521, "cai"}, // 蔡
+    {0x857E, "lei"}, // 蕾
+    {0x8587, "wei"}, // 薇
+    {0x859B, "xue"}, // 薛
+    {0x85CF, "zang|cang"}, // 藏
+    {0x884C, "xing|hang"}, // 行
+    {0x8881, "yuan"}, // 袁
+    {0x88F4, "pei"}, // 裴
+    {0x891A, "chu"}, // 褚
+    {0x897F, "xi"}, // 西
+    {0x8983, "qin|tan"}, // 覃
+    {0x89E3, "xie|jie"}, // 解
+    {0x8BA1, "ji"}, // 计
+    {0x8BA8, "tao"}, // 讨
+    {0x8BB8, "xu"}, // 许
+    {0x8BBA, "lun"}, // 论
+    {0x8BD7, "shi"}, // 诗
+    {0x8C22, "xie"}, // 谢
+    {0x8C2D, "tan"}, // 谭
+    {0x8D1D, "bei"}, // 贝
+    {0x8D22, "cai"}, // 财
+    {0x8D39, "fei"}, // 费
+    {0x8D3A, "he"}, // 贺
+    {0x8D3E, "jia"}, // 贾
+    {0x8D75, "zhao"}, // 赵
+    {0x8D85, "chao"}, // 超
+    {0x8DEF, "lu"}, // 路
+    {0x8F69, "xuan"}, // 轩
+    {0x8F89, "hui"}, // 辉
+    {0x8FD0, "yun"}, // 运
+    {0x9093, "deng"}, // 邓
+    {0x90A2, "xing"}, // 邢
+    {0x90B1, "qiu"}, // 邱
+    {0x90B5, "shao"}, // 邵
+    {0x90B9, "zou"}, // 邹
+    {0x90CE, "lang"}, // 郎
+    {0x90D1, "zheng"}, // 郑
+    {0x90DD, "hao"}, // 郝
+    {0x90E8, "bu"}, // 部
+    {0x90FD, "du|dou"}, // 都
+    {0x91CD, "chong|zhong"}, // 重
+    {0x91D1, "jin"}, // 金
+    {0x946B, "xin"}, // 鑫
+    {0x949F, "zhong"}, // 钟
+    {0x94B1, "qian"}, // 钱
+    {0x94ED, "ming"}, // 铭
+    {0x9500, "xiao"}, // 销
+    {0x957F, "chang|zhang"}, // 长
+    {0x95E8, "men"}, // 门
+    {0x961F, "dui"}, // 队
+    {0x962E, "ruan"}, // 阮
+    {0x9633, "yang"}, // 阳
+    {0x9646, "lu|liu"}, // 陆
+    {0x9648, "chen"}, // 陈
+    {0x9676, "tao"}, // 陶
+    {0x96C5, "ya"}, // 雅
+    {0x96E8, "yu"}, // 雨
+    {0x96EA, "xue"}, // 雪
+    {0x96F7, "lei"}, // 雷
+    {0x970D, "huo"}, // 霍
+    {0x971E, "xia"}, // 霞
+    {0x9759, "jing"}, // 静
+    {0x97E6, "wei"}, // 韦
+    {0x97E9, "han"}, // 韩
+    {0x9879, "xiang"}, // 项
+    {0x987E, "gu"}, // 顾
+    {0x9896, "ying"}, // 颖
+    {0x98DE, "fei"}, // 飞
+    {0x9A6C, "ma"}, // 马
+    {0x9AD8, "gao"}, // 高
+    {0x9B4F, "wei"}, // 魏
+    {0x9C81, "lu"}, // 鲁
+    {0x9C8D, "bao"}, // 鲍
+    {0x9E3F, "hong"}, // 鸿
+    {0x9E4F, "peng"}, // 鹏
+    {0x9EC4, "huang"}, // 黄
+    {0x9F50, "qi"}, // 齐
+    {0x9F99, "long"}, // 龙
+    {0x9F9A, "gong"}, // 龚
+};
+
+const int PINYIN_COUNT = sizeof(PINYIN_TABLE) / sizeof(PINYIN_TABLE[0]);
+
+const PinyinEntry *findEntry(QChar ch)
+{
+    const PinyinEntry *end = PINYIN_TABLE + PINYIN_COUNT;
+    const PinyinEntry *it = std::lower_bound(PINYIN_TABLE, end, ch.unicode(),
+        [](const PinyinEntry &entry, char16_t code) { return entry.ch < code; });
+    if (it == end || it->ch != ch.unicode())
+        return nullptr;
+    return it;
+}
+
+} // namespace
+
+QStringList PinyinTable::readings(QChar ch)
+{
+    const PinyinEntry *entry = findEntry(ch);
+    if (!entry)
+        return QStringList();
+    return QString::fromLatin1(entry->readings).split('|');
+}
+
+QStringList PinyinTable::keys(const QString &text)
+{
+    // 每种组合同时累积全拼和首字母
+    QStringList fulls{QString()};
+    QStringList initials{QString()};
+    bool converted = false;
+
+    for (QChar ch : text) {
+        QStringList options = readings(ch);
+        if (options.isEmpty()) {
+            // 字母数字等原样保留，保证“A组王伟”之类的混合名称也能连续匹配
+            QString kept(ch.toCaseFolded());
+            for (int i = 0; i < fulls.size(); ++i) {
+                fulls[i] += kept;
+                initials[i] += kept;
+            }
+            continue;
+        }
+        converted = true;
+        // 组合数已满时只取常用读音
+        if (fulls.size() * options.size() > MAX_VARIANTS)
+            options = options.mid(0, 1);
+
+        QStringList nextFulls;
+        QStringList nextInitials;
+        for (int i = 0; i < fulls.size(); ++i) {
+            for (const QString &option : std::as_const(options)) {
+                nextFulls.append(fulls[i] + option);
+                nextInitials.append(initials[i] + option.at(0));
+            }
+        }
+        fulls = nextFulls;
+        initials = nextInitials;
+    }
+
+    if (!converted)
+        return QStringList();
+    QStringList result = fulls + initials;
+    result.removeDuplicates();
+    return result;
+}
+
+int PinyinTable::size()
+{
+    return PINYIN_COUNT;
+}
+
+qint64 PinyinTable::memoryBytes()
+{
+    qint64 bytes = sizeof(PINYIN_TABLE);
+    for (const PinyinEntry &entry : PINYIN_TABLE) {
+        bytes += qint64(std::strlen(entry.readings)) + 1;
+    }
+    return bytes;
+}
@@ -0,0 +1,28 @@
+#ifndef PINYINTABLE_H
+#define PINYINTABLE_H
+
+#include <QString>
+#include <QStringList>
+
+/**
+ * @brief 内置拼音表
+ * 只收录常见姓氏、名字用字和群名用字，按码点排序后二分查找；
+ * 多音字的读音用“|”分隔，常用读音在前。
+ */
+class PinyinTable
+{
+public:
+    // 单字的所有读音，表中没有的字返回空
+    static QStringList readings(QChar ch);
+    // 文本的拼音检索键：每种读音组合的全拼和首字母（如“王伟”->wangwei、ww），
+    // 文本中没有可转换的汉字时返回空
+    static QStringList keys(const QString &text);
+    // 收录的字数
+    static int size();
+    // 表本身占用的字节数
+    static qint64 memoryBytes();
+
+    static const int MAX_VARIANTS = 4; // 多音字组合的上限，超出后只取常用读音
+};
+
+#endif // PINYINTABLE_H
@@ -32,8 +32,6 @@ RegisterDialog::RegisterDialog(QWidget *parent)
         ui->confirmLineEdit->setEchoMode(isPasswordHidden ? QLineEdit::Normal : QLineEdit::Password);
         toggleChkAction->setIcon(isPasswordHidden ? QIcon(":/LogReg/res/eye_open.png") : QIcon(":/LogReg/res/eye_close.png"));
     });
-    ui->pwdLineEdit->setStyleSheet("QLineEdit { padding-right: 25px; }");
-    ui->confirmLineEdit->setStyleSheet("QLineEdit { padding-right: 25px; }");
 
     // ui->userTip->hide();
     // ui->emailTip->hide();
@@ -31,8 +31,6 @@ ResetDialog::ResetDialog(QWidget *parent)
         ui->confirmLineEdit->setEchoMode(isPasswordHidden ? QLineEdit::Normal : QLineEdit::Password);
         toggleChkAction->setIcon(isPasswordHidden ? QIcon(":/LogReg/res/eye_open.png") : QIcon(":/LogReg/res/eye_close.png"));
     });
-    ui->pwdLineEdit->setStyleSheet("QLineEdit { padding-right: 25px; }");
-    ui->confirmLineEdit->setStyleSheet("QLineEdit { padding-right: 25px; }");
 
     connect(ui->userLineEdit, &QLineEdit::editingFinished, this, [this](){
         checkUserValid();
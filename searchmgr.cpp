@@ -0,0 +1,57 @@
+#include "searchmgr.h"
+#include "searchworker.h"
+
+SearchMgr::SearchMgr() : _worker(nullptr), _generation(0)
+{
+    qRegisterMetaType<QVector<SearchHit>>("QVector<SearchHit>");
+    _worker = new SearchWorker(&_generation);
+    _worker->moveToThread(&_thread);
+    // 结果从搜索线程排队回到界面线程
+    connect(_worker, &SearchWorker::sig_results, this, &SearchMgr::sig_search_results, Qt::QueuedConnection);
+    _thread.setObjectName("SearchThread");
+    _thread.start();
+}
+
+SearchMgr::~SearchMgr()
+{
+    cancelSearch();
+    _thread.quit();
+    _thread.wait();
+    delete _worker;
+}
+
+void SearchMgr::rebuild(const QVector<SearchDoc> &docs)
+{
+    QMetaObject::invokeMethod(_worker, [worker = _worker, docs]() {
+        worker->rebuild(docs);
+    }, Qt::QueuedConnection);
+}
+
+void SearchMgr::upsert(const SearchDoc &doc)
+{
+    QMetaObject::invokeMethod(_worker, [worker = _worker, doc]() {
+        worker->upsert(doc);
+    }, Qt::QueuedConnection);
+}
+
+void SearchMgr::remove(int id)
+{
+    QMetaObject::invokeMethod(_worker, [worker = _worker, id]() {
+        worker->remove(id);
+    }, Qt::QueuedConnection);
+}
+
+int SearchMgr::requestSearch(const QString &text, int limit)
+{
+    // 先推进代号，正在执行的旧查询会在下一块之前发现并退出
+    int generation = _generation.fetch_add(1) + 1;
+    QMetaObject::invokeMethod(_worker, [worker = _worker, generation, text, limit]() {
+        worker->search(generation, text, limit);
+    }, Qt::QueuedConnection);
+    return generation;
+}
+
+void SearchMgr::cancelSearch()
+{
+    _generation.fetch_add(1);
+}
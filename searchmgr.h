@@ -0,0 +1,47 @@
+#ifndef SEARCHMGR_H
+#define SEARCHMGR_H
+#include <QObject>
+#include <QThread>
+#include <atomic>
+#include "singleton.h"
+#include "chatsearchindex.h"
+
+class SearchWorker;
+
+/**
+ * @brief 会话搜索服务
+ * 索引由搜索线程独占，会话列表的增删改和搜索框的查询都投递到该线程执行，界面线程从不等待；
+ * 每次查询分配新的代号，旧代号的查询在下一块候选前自行放弃。
+ */
+class SearchMgr : public QObject, public Singleton<SearchMgr>,
+                  public std::enable_shared_from_this<SearchMgr>
+{
+    Q_OBJECT
+public:
+    friend class Singleton<SearchMgr>;
+    ~SearchMgr();
+    // 重建整个索引（会话列表整体加载时）
+    void rebuild(const QVector<SearchDoc> &docs);
+    // 新增或更新一个会话
+    void upsert(const SearchDoc &doc);
+    // 删除一个会话
+    void remove(int id);
+    // 发起查询并取消之前的查询，返回本次查询的代号，结果通过sig_search_results分批返回
+    int requestSearch(const QString &text, int limit = DEFAULT_LIMIT);
+    // 取消正在进行的查询（搜索框清空时）
+    void cancelSearch();
+
+    static const int DEFAULT_LIMIT = 50; // 默认最多返回的结果数
+
+signals:
+    void sig_search_results(int generation, const QVector<SearchHit> &hits, bool finished);
+
+private:
+    SearchMgr();
+
+    QThread _thread;                    // 搜索线程
+    SearchWorker *_worker;              // 运行在搜索线程上
+    std::atomic<int> _generation;       // 最新的查询代号
+};
+
+#endif // SEARCHMGR_H
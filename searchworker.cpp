@@ -0,0 +1,42 @@
+#include "searchworker.h"
+#include <QElapsedTimer>
+#include <QDebug>
+
+SearchWorker::SearchWorker(const std::atomic<int> *latestGeneration, QObject *parent)
+    : QObject(parent), _latestGeneration(latestGeneration)
+{
+}
+
+void SearchWorker::rebuild(const QVector<SearchDoc> &docs)
+{
+    QElapsedTimer timer;
+    timer.start();
+    _index.build(docs);
+    qDebug() << "搜索索引重建:" << _index.size() << "项, 耗时" << timer.elapsed() << "ms";
+}
+
+void SearchWorker::upsert(const SearchDoc &doc)
+{
+    _index.upsert(doc);
+}
+
+void SearchWorker::remove(int id)
+{
+    _index.remove(id);
+}
+
+void SearchWorker::search(int generation, const QString &text, int limit)
+{
+    // 排队期间又有新的按键，直接丢弃
+    auto cancelled = [this, generation]() {
+        return generation != _latestGeneration->load(std::memory_order_relaxed);
+    };
+    if (cancelled())
+        return;
+
+    _index.search(text, limit,
+                  [this, generation](const QVector<SearchHit> &hits, bool finished) {
+                      emit sig_results(generation, hits, finished);
+                  },
+                  cancelled);
+}
@@ -0,0 +1,33 @@
+#ifndef SEARCHWORKER_H
+#define SEARCHWORKER_H
+#include <QObject>
+#include <atomic>
+#include "chatsearchindex.h"
+
+/**
+ * @brief 搜索工作对象
+ * 运行在搜索线程上并独占索引，索引的修改和查询都以队列方式投递过来，按到达顺序执行；
+ * 查询带代号，代号落后于最新代号即视为已取消。
+ */
+class SearchWorker : public QObject
+{
+    Q_OBJECT
+public:
+    explicit SearchWorker(const std::atomic<int> *latestGeneration, QObject *parent = nullptr);
+
+    // 以下函数只在搜索线程上调用
+    void rebuild(const QVector<SearchDoc> &docs);
+    void upsert(const SearchDoc &doc);
+    void remove(int id);
+    void search(int generation, const QString &text, int limit);
+
+signals:
+    // 分批返回的结果，每次都是当前的前limit条，finished表示本次查询结束
+    void sig_results(int generation, const QVector<SearchHit> &hits, bool finished);
+
+private:
+    const std::atomic<int> *_latestGeneration; // 由SearchMgr持有的最新查询代号
+    ChatSearchIndex _index;
+};
+
+#endif // SEARCHWORKER_H
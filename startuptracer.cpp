@@ -0,0 +1,81 @@
+#include "startuptracer.h"
+#include <QCoreApplication>
+#include <QTimer>
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+
+StartupTracer::StartupTracer() : _firstFrameSeen(false)
+{
+    _events.reserve(256);
+}
+
+StartupTracer::~StartupTracer()
+{
+}
+
+void StartupTracer::begin(const char *name)
+{
+    record(name, 'B');
+}
+
+void StartupTracer::end(const char *name)
+{
+    record(name, 'E');
+}
+
+void StartupTracer::instant(const char *name)
+{
+    record(name, 'i');
+}
+
+void StartupTracer::record(const char *name, char phase)
+{
+    if (_events.size() >= MAX_EVENTS) // 防止异常情况下无限增长，超过上限不再记录
+        return;
+    _events.append(TraceEvent{QByteArray(name), phase, app_start_timer.nsecsElapsed() / 1000});
+}
+
+void StartupTracer::markFirstFrame(const char *name)
+{
+    if (_firstFrameSeen)
+        return;
+    _firstFrameSeen = true;
+    instant(name);
+    // 固定格式的一行，供启动压测脚本解析
+    qDebug().noquote() << "startup_first_frame_ms" << app_start_timer.elapsed();
+    if (qEnvironmentVariableIsSet("BAIJIU_EXIT_AFTER_FIRST_FRAME")) {
+        QTimer::singleShot(0, qApp, &QCoreApplication::quit);
+    }
+}
+
+void StartupTracer::writeTraceIfRequested()
+{
+    const QString path = qEnvironmentVariable("BAIJIU_STARTUP_TRACE");
+    if (path.isEmpty())
+        return;
+
+    QJsonArray traceEvents;
+    for (const TraceEvent &event : std::as_const(_events)) {
+        QJsonObject item;
+        item["name"] = QString::fromUtf8(event.name);
+        item["ph"] = QString(QChar(event.phase));
+        item["ts"] = event.us;
+        item["pid"] = 1;
+        item["tid"] = 1;
+        if (event.phase == 'i')
+            item["s"] = "g"; // 全局范围的单点事件
+        traceEvents.append(item);
+    }
+    QJsonObject root;
+    root["traceEvents"] = traceEvents;
+
+    QFile file(path);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        qDebug() << "写入启动trace失败:" << path << file.errorString();
+        return;
+    }
+    file.write(QJsonDocument(root).toJson(QJsonDocument::Compact));
+    qDebug() << "启动trace已写入:" << path << "," << _events.size() << "个事件";
+}
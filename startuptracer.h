@@ -0,0 +1,69 @@
+#ifndef STARTUPTRACER_H
+#define STARTUPTRACER_H
+#include <QObject>
+#include <QVector>
+#include <QByteArray>
+#include "singleton.h"
+
+/**
+ * @brief 启动阶段记录器
+ * 以main开头启动的单调时钟为基准记录各阶段的起止和单点事件；
+ * 设置BAIJIU_STARTUP_TRACE=文件路径时，退出前写出Chrome trace格式的JSON（chrome://tracing或Perfetto可直接打开）；
+ * 设置BAIJIU_EXIT_AFTER_FIRST_FRAME时，首帧绘制后立即退出，供启动压测脚本使用。
+ */
+class StartupTracer : public QObject, public Singleton<StartupTracer>,
+                      public std::enable_shared_from_this<StartupTracer>
+{
+    Q_OBJECT
+public:
+    friend class Singleton<StartupTracer>;
+    ~StartupTracer();
+    // 阶段开始/结束，须成对调用（可嵌套）
+    void begin(const char *name);
+    void end(const char *name);
+    // 单点事件
+    void instant(const char *name);
+    // 首帧绘制：只有第一次调用生效
+    void markFirstFrame(const char *name);
+    // 首帧之前为真，之后的热路径不再记录
+    bool isActive() const { return !_firstFrameSeen; }
+    // 设置了环境变量时写出trace文件
+    void writeTraceIfRequested();
+
+private:
+    StartupTracer();
+
+    struct TraceEvent {
+        QByteArray name;
+        char phase;     // 'B'开始 'E'结束 'i'单点
+        qint64 us;      // 距启动的微秒数
+    };
+    void record(const char *name, char phase);
+
+    static const int MAX_EVENTS = 4096;
+
+    QVector<TraceEvent> _events;
+    bool _firstFrameSeen;
+};
+
+// 作用域内的阶段：构造时开始，析构时结束；只在首帧之前记录，开始和结束按构造时的状态成对写入
+class TracePhase
+{
+public:
+    explicit TracePhase(const char *name) : _name(name), _active(StartupTracer::GetInstance()->isActive())
+    {
+        if (_active)
+            StartupTracer::GetInstance()->begin(_name);
+    }
+    ~TracePhase()
+    {
+        if (_active)
+            StartupTracer::GetInstance()->end(_name);
+    }
+
+private:
+    const char *_name;
+    bool _active;
+};
+
+#endif // STARTUPTRACER_H
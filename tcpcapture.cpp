@@ -0,0 +1,90 @@
+#include "tcpcapture.h"
+#include <QDateTime>
+#include <QDebug>
+
+TcpCapture::TcpCapture() : _lastUs(0), _frames(0), _bytes(0)
+{
+}
+
+TcpCapture::~TcpCapture()
+{
+    close();
+}
+
+bool TcpCapture::open(const QString &path)
+{
+    close();
+    _file.setFileName(path);
+    if (!_file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        qDebug() << "抓包文件打开失败:" << path << _file.errorString();
+        return false;
+    }
+    _stream.setDevice(&_file);
+    _stream << MAGIC << VERSION << QDateTime::currentMSecsSinceEpoch();
+    _clock.start();
+    _lastUs = 0;
+    _frames = 0;
+    _bytes = 0;
+    qDebug() << "开始抓包:" << path;
+    return true;
+}
+
+void TcpCapture::close()
+{
+    if (!_file.isOpen())
+        return;
+    _stream.setDevice(nullptr);
+    _file.close();
+    qDebug() << "抓包结束:" << _frames << "帧," << _bytes << "字节";
+}
+
+void TcpCapture::write(bool outbound, quint16 id, const QByteArray &body)
+{
+    if (!_file.isOpen())
+        return;
+    const qint64 nowUs = _clock.nsecsElapsed() / 1000;
+    const quint32 deltaUs = quint32(qMin<qint64>(nowUs - _lastUs, 0xFFFFFFFF));
+    _lastUs = nowUs;
+    // 写入QFile自带的缓冲，不逐帧flush
+    _stream << quint8(outbound ? 1 : 0) << deltaUs << id << quint16(body.size());
+    _stream.writeRawData(body.constData(), int(body.size()));
+    ++_frames;
+    _bytes += body.size();
+}
+
+bool TcpCapture::load(const QString &path, QVector<CaptureFrame> &frames)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        qDebug() << "抓包文件打开失败:" << path << file.errorString();
+        return false;
+    }
+    QDataStream stream(&file);
+    quint32 magic = 0;
+    quint16 version = 0;
+    qint64 startMs = 0;
+    stream >> magic >> version >> startMs;
+    if (magic != MAGIC || version != VERSION) {
+        qDebug() << "不是抓包文件或版本不支持:" << path;
+        return false;
+    }
+
+    qint64 timeUs = 0;
+    while (!stream.atEnd()) {
+        quint8 direction = 0;
+        quint32 deltaUs = 0;
+        CaptureFrame frame;
+        quint16 len = 0;
+        stream >> direction >> deltaUs >> frame.id >> len;
+        frame.body.resize(len);
+        if (stream.status() != QDataStream::Ok || stream.readRawData(frame.body.data(), len) != len) {
+            qDebug() << "抓包文件在第" << frames.size() << "帧处截断";
+            return false;
+        }
+        timeUs += deltaUs;
+        frame.outbound = direction != 0;
+        frame.timeUs = timeUs;
+        frames.append(frame);
+    }
+    return true;
+}
@@ -0,0 +1,52 @@
+#ifndef TCPCAPTURE_H
+#define TCPCAPTURE_H
+#include <QFile>
+#include <QDataStream>
+#include <QElapsedTimer>
+#include <QVector>
+
+// 抓包文件中的一帧
+struct CaptureFrame {
+    bool outbound;      // true为客户端发出，false为收到
+    qint64 timeUs;      // 距抓包开始的微秒数
+    quint16 id;         // 消息ID
+    QByteArray body;    // 消息体
+
+    CaptureFrame() : outbound(false), timeUs(0), id(0) {}
+};
+
+/**
+ * @brief 聊天通道抓包文件
+ * 按帧记录收发的报文，格式（大端）：
+ *   文件头  "BJCP" | quint16 版本 | qint64 开始时的墙钟毫秒
+ *   每一帧  quint8 方向 | quint32 距上一帧的微秒数 | quint16 消息ID | quint16 长度 | 消息体
+ * 帧头只比线上多5字节；相邻两帧的间隔超过quint32范围（约71分钟）时按上限记录。
+ */
+class TcpCapture
+{
+public:
+    TcpCapture();
+    ~TcpCapture();
+
+    bool open(const QString &path);
+    void close();
+    bool isOpen() const { return _file.isOpen(); }
+    // 记录一帧，未打开时忽略
+    void write(bool outbound, quint16 id, const QByteArray &body);
+
+    // 读出整个抓包文件，格式错误返回false（已读出的帧保留在frames里）
+    static bool load(const QString &path, QVector<CaptureFrame> &frames);
+
+private:
+    QFile _file;
+    QDataStream _stream;
+    QElapsedTimer _clock;
+    qint64 _lastUs;     // 上一帧的时间
+    qint64 _frames;     // 已记录的帧数
+    qint64 _bytes;      // 已记录的消息体字节数
+
+    static const quint32 MAGIC = 0x424A4350; // "BJCP"
+    static const quint16 VERSION = 1;
+};
+
+#endif // TCPCAPTURE_H
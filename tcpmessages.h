@@ -0,0 +1,96 @@
+#ifndef TCPMESSAGES_H
+#define TCPMESSAGES_H
+#include <QString>
+#include <QVector>
+#include <QPair>
+#include "jsonschema.h"
+
+// 聊天通道上收到的报文，字段描述见各结构体的fields()
+
+// ID_CHAT_LOGIN_RSP 聊天登录响应，失败时只有error
+struct ChatLoginRsp {
+    int error = 0;
+    int uid = 0;
+    QString name;
+    QString token;
+
+    static constexpr auto fields()
+    {
+        return std::make_tuple(requiredField("error", &ChatLoginRsp::error),
+                               optionalField("uid", &ChatLoginRsp::uid),
+                               optionalField("name", &ChatLoginRsp::name),
+                               optionalField("token", &ChatLoginRsp::token));
+    }
+};
+
+// 同步响应中的一个会话（键名尽量短以减少流量）
+struct SyncChatItem {
+    int id = 0;
+    QString name;       // n
+    QString avatar;     // a
+    QString preview;    // p
+    qint64 timeMs = 0;  // t
+    int unread = 0;     // u
+    bool muted = false; // m
+    bool group = false; // g
+
+    static constexpr auto fields()
+    {
+        return std::make_tuple(requiredField("id", &SyncChatItem::id),
+                               optionalField("n", &SyncChatItem::name),
+                               optionalField("a", &SyncChatItem::avatar),
+                               optionalField("p", &SyncChatItem::preview),
+                               optionalField("t", &SyncChatItem::timeMs),
+                               optionalField("u", &SyncChatItem::unread),
+                               optionalField("m", &SyncChatItem::muted),
+                               optionalField("g", &SyncChatItem::group));
+    }
+};
+
+// ID_SYNC_CHAT_LIST_RSP 会话列表增量同步响应
+struct SyncChatListRsp {
+    int error = 0;
+    qint64 cursor = 0;
+    bool more = false;
+    QVector<SyncChatItem> upserts;
+    QVector<int> removes;
+    QVector<QPair<int, int>> unread; // (id, 未读数)
+
+    static constexpr auto fields()
+    {
+        return std::make_tuple(requiredField("error", &SyncChatListRsp::error),
+                               optionalField("cursor", &SyncChatListRsp::cursor),
+                               optionalField("more", &SyncChatListRsp::more),
+                               optionalField("upserts", &SyncChatListRsp::upserts),
+                               optionalField("removes", &SyncChatListRsp::removes),
+                               optionalField("unread", &SyncChatListRsp::unread));
+    }
+};
+
+// ID_NOTIFY_CHAT_MSG 服务器推送的新消息
+struct ChatMessageNotify {
+    int chat = 0;
+    qint64 seq = 0;
+    QString text;
+    qint64 t = 0;   // 发送时间（毫秒）
+
+    static constexpr auto fields()
+    {
+        return std::make_tuple(requiredField("chat", &ChatMessageNotify::chat),
+                               optionalField("seq", &ChatMessageNotify::seq),
+                               requiredField("text", &ChatMessageNotify::text),
+                               requiredField("t", &ChatMessageNotify::t));
+    }
+};
+
+// 发送消息的累计确认：ack及之前的客户端消息id都已收到
+struct SendChatMsgAck {
+    qint64 ack = 0;
+
+    static constexpr auto fields()
+    {
+        return std::make_tuple(requiredField("ack", &SendChatMsgAck::ack));
+    }
+};
+
+#endif // TCPMESSAGES_H
@@ -1,8 +1,14 @@
 #include "tcpmgr.h"
 #include "usermgr.h"
+#include "localdb.h"
+#include "messagestore.h"
+#include "outboxmgr.h"
+#include <QDateTime>
 #include <QDebug>
 
-TcpMgr::TcpMgr() : _host(""), _port(0), _messageId(0), _messageLen(0), _recvPending(false)
+TcpMgr::TcpMgr() : _dispatcher(this), _host(""), _port(0), _messageId(0), _messageLen(0), _recvPending(false),
+    _syncBytes(0), _syncPages(0), _inboundCount(0), _inboundLatencyMs(0), _inboundMaxLatencyMs(0),
+    _laneReportNs(0), _handlingLen(0)
 {
     // 连接socket
     connect(&_socket, &QTcpSocket::connected, this, &TcpMgr::onConnected);
@@ -16,6 +22,12 @@ TcpMgr::TcpMgr() : _host(""), _port(0), _messageId(0), _messageLen(0), _recvPend
     // 连接发送信号
     connect(this, &TcpMgr::sig_send_data, this, &TcpMgr::slot_sent_data);
 
+    // 批量通道没处理完时，先回到事件循环收包、绘制，再继续
+    _laneClock.start();
+    _bulkTimer.setSingleShot(true);
+    _bulkTimer.setInterval(0);
+    connect(&_bulkTimer, &QTimer::timeout, this, &TcpMgr::drainLanes);
+
     // 初始化消息处理函数
     initHandlers();
 }
@@ -85,19 +97,89 @@ void TcpMgr::processBuffer()
             // 重置流
             stream.device()->seek(0);
 
-            // 处理消息
+            // 按优先级入队，本次收到的帧全部拆完后统一处理
             qDebug() << "收到消息，ID:" << _messageId << "长度:" << _messageLen;
-            handleMsg(static_cast<ReqId>(_messageId), _messageLen, msgBody);
+            _capture.write(false, _messageId, msgBody);
+            const ReqId id = static_cast<ReqId>(_messageId);
+            _lanes[laneOf(id)].enqueue({id, msgBody, _laneClock.nsecsElapsed()});
 
             // 重置接收状态
             _recvPending = false;
         }
     }
+    drainLanes();
+}
+
+InboundLane TcpMgr::laneOf(ReqId id)
+{
+    switch (id) {
+    case ReqId::ID_CHAT_LOGIN_RSP:
+        return LANE_CONTROL;
+    case ReqId::ID_SYNC_CHAT_LIST_RSP:
+        return LANE_BULK;
+    default:
+        return LANE_INTERACTIVE;
+    }
+}
+
+// 同在GUI线程，处理期间不会有新帧入队；批量帧之间检查时间片，
+// 用完就让出事件循环，其间到达的登录回包和新消息会在下一轮先于剩余批量帧处理。
+// 单个批量帧不可再分，时间片只在帧之间生效。
+void TcpMgr::drainLanes()
+{
+    for (InboundLane lane : {LANE_CONTROL, LANE_INTERACTIVE}) {
+        while (!_lanes[lane].isEmpty()) {
+            handleFrame(lane, _lanes[lane].dequeue());
+        }
+    }
+
+    QElapsedTimer slice;
+    slice.start();
+    while (!_lanes[LANE_BULK].isEmpty()) {
+        if (slice.elapsed() >= BULK_SLICE_MS) {
+            _bulkTimer.start();
+            break;
+        }
+        handleFrame(LANE_BULK, _lanes[LANE_BULK].dequeue());
+    }
+
+    if (_laneClock.nsecsElapsed() - _laneReportNs >= 1000000000LL)
+        reportLaneStats();
+}
+
+void TcpMgr::handleFrame(InboundLane lane, const InboundFrame &frame)
+{
+    const qint64 startNs = _laneClock.nsecsElapsed();
+    LaneStats &stats = _laneStats[lane];
+    const qint64 waitNs = startNs - frame.enqueuedNs;
+    ++stats.frames;
+    stats.waitSumNs += waitNs;
+    stats.maxWaitNs = qMax(stats.maxWaitNs, waitNs);
+
+    _handlingLen = frame.body.size();
+    handleMsg(frame.id, frame.body);
+    stats.busyNs += _laneClock.nsecsElapsed() - startNs;
+}
+
+void TcpMgr::reportLaneStats()
+{
+    static const char *const LANE_NAMES[LANE_COUNT] = {"控制", "交互", "批量"};
+    for (int lane = 0; lane < LANE_COUNT; ++lane) {
+        LaneStats &stats = _laneStats[lane];
+        if (stats.frames == 0)
+            continue;
+        qDebug() << "通道" << LANE_NAMES[lane] << ":" << stats.frames << "帧, 排队平均"
+                 << stats.waitSumNs / stats.frames / 1000 << "us, 最大" << stats.maxWaitNs / 1000
+                 << "us, 处理" << stats.busyNs / 1000 << "us, 待处理" << _lanes[lane].size();
+        stats = LaneStats();
+    }
+    _laneReportNs = _laneClock.nsecsElapsed();
 }
 
 void TcpMgr::onDisconnected()
 {
     qDebug() << "socket已断开";
+    OutboxMgr::GetInstance()->suspend();
     emit sig_disconnected();
 }
 
@@ -116,55 +198,131 @@ void TcpMgr::slot_tcp_connect(ServerInfo serverInfo)
     _socket.connectToHost(_host, _port);
 }
 
-// 注册消息处理函数
+// 注册消息处理函数：报文体先按处理函数声明的结构体解码，字段描述见tcpmessages.h
 void TcpMgr::initHandlers()
 {
-    // 注册登录处理函数
-    _handlers.insert(ReqId::ID_LOGIN_USER, [this](ReqId id, int len, QByteArray data) {
-        Q_UNUSED(id)
-        Q_UNUSED(len)
+    _dispatcher.on<ReqId::ID_CHAT_LOGIN_RSP, &TcpMgr::onChatLoginRsp>();
+    _dispatcher.on<ReqId::ID_SYNC_CHAT_LIST_RSP, &TcpMgr::onSyncChatListRsp>();
+    _dispatcher.on<ReqId::ID_NOTIFY_CHAT_MSG, &TcpMgr::onChatMessageNotify>();
+    _dispatcher.on<ReqId::ID_SEND_CHAT_MSG_ACK, &TcpMgr::onSendChatMsgAck>();
+    // 可以在这里添加更多消息处理函数...
+}
 
-        // 解析JSON响应
-        QJsonDocument doc = QJsonDocument::fromJson(data);
-        if (doc.isNull() || !doc.isObject()) {
-            qDebug() << "JSON解析失败";
-            emit sig_login_failed(ErrorCodes::ERR_JSON);
-            return;
-        }
+// 聊天服务器的登录回包
+void TcpMgr::onChatLoginRsp(const ChatLoginRsp &rsp)
+{
+    if (rsp.error != ErrorCodes::SUCCESS) {
+        qDebug() << "登录失败，错误码：" << rsp.error;
+        emit sig_login_failed(rsp.error);
+        return;
+    }
 
-        QJsonObject jsonObj = doc.object();
-        if (!jsonObj.contains("error")) {
-            qDebug() << "JSON格式错误：缺少error字段";
-            emit sig_login_failed(ErrorCodes::ERR_JSON);
-            return;
-        }
+    // 登录成功
+    UserMgr::GetInstance()->SetUid(rsp.uid);
+    UserMgr::GetInstance()->SetName(rsp.name);
+    UserMgr::GetInstance()->SetToken(rsp.token);
+    qDebug() << "登录成功";
+    if (login_timer.isValid())
+        qDebug() << "聊天登录完成: 距点击登录" << login_timer.elapsed() << "ms";
+    // 打开该用户的发件箱，上次没确认的消息从这里开始重发
+    if (OutboxMgr::GetInstance()->open(rsp.uid))
+        OutboxMgr::GetInstance()->resume();
+    emit sig_switch_chatdlg();
+
+    // 每次登录（包括断线重连）都从本地游标开始增量同步
+    _syncBytes = 0;
+    _syncPages = 0;
+    _syncClock.start();
+    requestChatSync();
+}
 
-        int error = jsonObj["error"].toInt();
-        if (error != ErrorCodes::SUCCESS) {
-            qDebug() << "登录失败，错误码：" << error;
-            emit sig_login_failed(error);
-            return;
-        }
+// 会话列表增量同步的一页
+void TcpMgr::onSyncChatListRsp(const SyncChatListRsp &rsp)
+{
+    if (rsp.error != ErrorCodes::SUCCESS) {
+        qDebug() << "会话同步失败，错误码：" << rsp.error;
+        return;
+    }
 
-        // 登录成功
-        UserMgr::GetInstance()->SetUid(jsonObj["uid"].toInt());
-        UserMgr::GetInstance()->SetName(jsonObj["name"].toString());
-        UserMgr::GetInstance()->SetToken(jsonObj["token"].toString());
-        qDebug() << "登录成功";
-        emit sig_switch_chatdlg();
-    });
+    ChatListDelta delta;
+    delta.cursor = rsp.cursor;
+    delta.upserts.reserve(rsp.upserts.size());
+    for (const SyncChatItem &item : rsp.upserts) {
+        delta.upserts.append(ChatItemData(item.id, item.avatar, item.name, item.preview,
+                                          QDateTime::fromMSecsSinceEpoch(item.timeMs),
+                                          item.unread, item.muted, true, item.group));
+    }
+    delta.removes = rsp.removes;
+    delta.unreadChanges = rsp.unread;
 
-    // 可以在这里添加更多消息处理函数...
+    // 接收方同步应用并写入写后队列，游标排在这些写入之后落盘
+    emit sig_chat_list_delta(delta);
+    LocalDb::GetInstance()->enqueueMetaValue("chat_sync_cursor", QString::number(delta.cursor));
+
+    _syncBytes += sizeof(quint16) * 2 + _handlingLen;
+    ++_syncPages;
+    if (rsp.more) {
+        requestChatSync();
+        return;
+    }
+    qDebug() << "会话同步完成: 游标" << delta.cursor << ", 共" << _syncPages << "页"
+             << _syncBytes << "字节, 耗时" << _syncClock.elapsed() << "ms";
+    if (login_timer.isValid()) {
+        qDebug() << "登录到会话同步完成:" << login_timer.elapsed() << "ms";
+        login_timer.invalidate(); // 断线重连的同步不再计入
+    }
+}
+
+// 服务器推送的新消息
+void TcpMgr::onChatMessageNotify(const ChatMessageNotify &notify)
+{
+    MessageData message = MessageStore::GetInstance()->appendMessage(notify.chat, false, notify.text, notify.t);
+    emit sig_chat_message(message);
+    recordInbound(notify.t);
 }
 
-void TcpMgr::handleMsg(ReqId id, int len, const QByteArray &data)
+// 发件箱消息的累计确认
+void TcpMgr::onSendChatMsgAck(const SendChatMsgAck &ack)
 {
-    // 查找并调用对应的消息处理函数
-    auto it = _handlers.find(id);
-    if (it != _handlers.end()) {
-        it.value()(id, len, data);
-    } else {
+    OutboxMgr::GetInstance()->acknowledge(ack.ack);
+}
+
+// 每秒输出一次推送的接收速率和端到端延迟（服务器与客户端在同一台机器上，时钟一致）
+void TcpMgr::recordInbound(qint64 sentMs)
+{
+    const qint64 latency = qMax<qint64>(0, QDateTime::currentMSecsSinceEpoch() - sentMs);
+    if (!_inboundClock.isValid())
+        _inboundClock.start();
+    ++_inboundCount;
+    _inboundLatencyMs += latency;
+    _inboundMaxLatencyMs = qMax(_inboundMaxLatencyMs, latency);
+
+    const qint64 elapsed = _inboundClock.elapsed();
+    if (elapsed < 1000)
+        return;
+    qDebug() << "入站消息:" << _inboundCount * 1000 / elapsed << "条/秒, 平均延迟"
+             << _inboundLatencyMs / _inboundCount << "ms, 最大" << _inboundMaxLatencyMs << "ms";
+    _inboundCount = 0;
+    _inboundLatencyMs = 0;
+    _inboundMaxLatencyMs = 0;
+    _inboundClock.restart();
+}
+
+void TcpMgr::handleMsg(ReqId id, const QByteArray &data)
+{
+    // 按ID下标直接取处理函数，解码失败的报文统一在这里报告
+    QString error;
+    switch (_dispatcher.dispatch(id, data, error)) {
+    case Dispatcher::Handled:
+        break;
+    case Dispatcher::Unregistered:
         qDebug() << "未注册的消息ID：" << id;
+        break;
+    case Dispatcher::DecodeFailed:
+        qDebug() << "报文格式错误, ID:" << id << error;
+        if (id == ReqId::ID_CHAT_LOGIN_RSP)
+            emit sig_login_failed(ErrorCodes::ERR_JSON);
+        break;
     }
 }
 
@@ -192,6 +350,24 @@ void TcpMgr::slot_sent_data(ReqId id, const QByteArray &data)
     if (written != sendBuffer.size()) {
         qDebug() << "发送数据不完整:" << written << "/" << sendBuffer.size();
     }
+    _capture.write(true, static_cast<quint16>(id), data);
+}
+
+void TcpMgr::setCaptureFile(const QString &path)
+{
+    if (path.isEmpty())
+        _capture.close();
+    else
+        _capture.open(path);
+}
+
+// 以本地游标请求增量，响应分页时由响应处理函数继续请求
+void TcpMgr::requestChatSync()
+{
+    QJsonObject jsonObj;
+    jsonObj["uid"] = UserMgr::GetInstance()->GetUid();
+    jsonObj["cursor"] = LocalDb::GetInstance()->metaValue("chat_sync_cursor", "0").toLongLong();
+    sendJsonData(ReqId::ID_SYNC_CHAT_LIST, jsonObj);
 }
 
 // 快捷发送JSON数据的方法
@@ -5,13 +5,47 @@
 #include <QObject> // 发送信号需要包含QObject
 #include <QJsonDocument>
 #include <QJsonObject>
+#include <QElapsedTimer>
+#include <QQueue>
+#include <QTimer>
 #include "singleton.h"
 #include "global.h"
+#include "chatitemdata.h"
+#include "messagedata.h"
+#include "tcpcapture.h"
+#include "msgdispatcher.h"
+#include "tcpmessages.h"
+
+// 收到的报文按优先级分三条通道排队
+enum InboundLane {
+    LANE_CONTROL,       // 控制：登录回包、心跳
+    LANE_INTERACTIVE,   // 交互：新消息、确认
+    LANE_BULK,          // 批量：会话同步、历史消息，按时间片处理
+    LANE_COUNT
+};
+
+// 排队中的一帧
+struct InboundFrame {
+    ReqId id;
+    QByteArray body;
+    qint64 enqueuedNs;  // 入队时间（TcpMgr通道时钟）
+};
+
+// 一条通道在统计窗口内的排队和处理耗时
+struct LaneStats {
+    int frames;
+    qint64 waitSumNs;   // 入队到开始处理
+    qint64 maxWaitNs;
+    qint64 busyNs;      // 处理函数耗时
+
+    LaneStats() : frames(0), waitSumNs(0), maxWaitNs(0), busyNs(0) {}
+};
 
 class TcpMgr: public QObject, public Singleton<TcpMgr>,
                public std::enable_shared_from_this<TcpMgr>
 {
     Q_OBJECT
+    friend class TcpReplayer; // 回放直接向接收缓冲区灌入字节
 public:
     ~TcpMgr();
     TcpMgr();
@@ -19,12 +53,27 @@ public:
     void connectToHost(const QString &host, quint16 port);
     void disconnect();
     void sendJsonData(ReqId id, const QJsonObject &jsonObj);
+    // 以本地游标请求会话列表增量
+    void requestChatSync();
+    // 把之后收发的每一帧记录到抓包文件，路径为空时停止记录
+    void setCaptureFile(const QString &path);
 
 private:
 
     void initHandlers();    // 注册通讯
-    void handleMsg(ReqId Id, int len, const QByteArray &data);
-    void processBuffer();   // 处理接收缓冲区
+    void handleMsg(ReqId id, const QByteArray &data);
+    void processBuffer();   // 处理接收缓冲区，拆出的帧按优先级入队
+    static InboundLane laneOf(ReqId id);
+    void drainLanes();      // 先处理控制和交互通道，再按时间片处理批量通道
+    void handleFrame(InboundLane lane, const InboundFrame &frame);
+    void reportLaneStats(); // 每秒输出各通道的排队延迟
+    void recordInbound(qint64 sentMs); // 统计推送消息的速率和延迟
+
+    // 消息处理函数，报文体已按结构体的字段描述解码校验
+    void onChatLoginRsp(const ChatLoginRsp &rsp);
+    void onSyncChatListRsp(const SyncChatListRsp &rsp);
+    void onChatMessageNotify(const ChatMessageNotify &notify);
+    void onSendChatMsgAck(const SendChatMsgAck &ack);
 
     // 信号槽处理方法
     void onConnected();
@@ -32,7 +81,8 @@ private:
     void onDisconnected();
     void onError(QAbstractSocket::SocketError socketError);
 
-    QMap<ReqId, std::function<void(ReqId id, int len, QByteArray data)>> _handlers;
+    using Dispatcher = MsgDispatcher<TcpMgr, TCP_MSG_ID_FIRST, TCP_MSG_ID_LAST>;
+    Dispatcher _dispatcher; // 消息ID -> 处理函数
     QTcpSocket _socket;     // 通讯用socket
     QString _host;          // socket绑定的IP
     uint16_t _port;         // port
@@ -40,6 +90,22 @@ private:
     quint16 _messageLen;    // 报文长度
     QByteArray _buffer;     // 报文内容的字节流
     bool _recvPending;      // 是否有报文截断（报文收全了没有）
+    qint64 _syncBytes;      // 本轮同步收到的字节数
+    int _syncPages;         // 本轮同步的响应页数
+    QElapsedTimer _syncClock; // 本轮同步计时
+    int _inboundCount;      // 统计窗口内收到的推送消息数
+    qint64 _inboundLatencyMs; // 统计窗口内的延迟总和
+    qint64 _inboundMaxLatencyMs; // 统计窗口内的最大延迟
+    QElapsedTimer _inboundClock; // 推送统计窗口计时
+    TcpCapture _capture;    // 抓包，未开启时不记录
+    QQueue<InboundFrame> _lanes[LANE_COUNT]; // 各优先级通道的待处理帧
+    LaneStats _laneStats[LANE_COUNT];
+    QElapsedTimer _laneClock; // 排队计时的基准
+    qint64 _laneReportNs;   // 上次输出通道统计的时间
+    QTimer _bulkTimer;      // 批量通道时间片用完后，下一轮事件循环继续
+    int _handlingLen;       // 正在处理的报文体长度，供处理函数统计流量
+
+    static const int BULK_SLICE_MS = 4; // 批量通道每个时间片的预算
 
 public slots:
     void slot_tcp_connect(ServerInfo serverInfo);
@@ -49,6 +115,8 @@ signals:
     void sig_con_success(bool bsuccess);
     void sig_send_data(ReqId reqId, const QByteArray &data);
     void sig_switch_chatdlg();
+    void sig_chat_list_delta(const ChatListDelta &delta); // 一页会话增量，接收方在一批中应用
+    void sig_chat_message(const MessageData &message); // 收到新消息（已写入消息存储）
     void sig_login_failed(int);
     void sig_disconnected();
     void sig_network_error(int errorCode, const QString &errorString);
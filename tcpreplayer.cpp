@@ -0,0 +1,107 @@
+#include "tcpreplayer.h"
+#include "tcpmgr.h"
+#include <QDebug>
+
+TcpReplayer::TcpReplayer(QObject *parent)
+    : QObject(parent), _next(0), _speed(1), _bytes(0), _lateSumUs(0), _maxLateUs(0), _slices(0)
+{
+    _timer.setSingleShot(true);
+    _timer.setTimerType(Qt::PreciseTimer);
+    connect(&_timer, &QTimer::timeout, this, &TcpReplayer::onTick);
+}
+
+bool TcpReplayer::start(const QString &path, double speed)
+{
+    QVector<CaptureFrame> frames;
+    if (!TcpCapture::load(path, frames) && frames.isEmpty())
+        return false;
+
+    _frames.clear();
+    for (const CaptureFrame &frame : std::as_const(frames)) {
+        if (!frame.outbound)
+            _frames.append(frame);
+    }
+    if (_frames.isEmpty()) {
+        qDebug() << "抓包文件里没有收到的帧:" << path;
+        return false;
+    }
+    const qint64 firstUs = _frames.first().timeUs;
+    for (CaptureFrame &frame : _frames) {
+        frame.timeUs -= firstUs;
+    }
+
+    _next = 0;
+    _speed = speed;
+    _bytes = 0;
+    _lateSumUs = 0;
+    _maxLateUs = 0;
+    _slices = 0;
+    qDebug() << "开始回放:" << path << "," << _frames.size() << "帧, 原始时长"
+             << _frames.last().timeUs / 1000 << "ms," << (speed > 0 ? QString("%1倍速").arg(speed) : QString("全速"));
+    _clock.start();
+    _timer.start(0);
+    return true;
+}
+
+void TcpReplayer::onTick()
+{
+    if (_speed <= 0) {
+        // 全速：每片处理到时间预算用完，然后把事件循环让给绘制和输入
+        QElapsedTimer slice;
+        slice.start();
+        while (_next < _frames.size() && slice.elapsed() < MAX_SPEED_SLICE_MS) {
+            deliver(_frames[_next++]);
+        }
+        ++_slices;
+    } else {
+        const qint64 nowUs = _clock.nsecsElapsed() / 1000;
+        while (_next < _frames.size()) {
+            const qint64 dueUs = qint64(_frames[_next].timeUs / _speed);
+            if (dueUs > nowUs)
+                break;
+            _lateSumUs += nowUs - dueUs;
+            _maxLateUs = qMax(_maxLateUs, nowUs - dueUs);
+            deliver(_frames[_next++]);
+        }
+    }
+
+    if (_next >= _frames.size()) {
+        finish();
+        return;
+    }
+    if (_speed <= 0) {
+        _timer.start(0);
+    } else {
+        const qint64 waitUs = qint64(_frames[_next].timeUs / _speed) - _clock.nsecsElapsed() / 1000;
+        _timer.start(int(qMax<qint64>(0, waitUs / 1000)));
+    }
+}
+
+// 拼回线上格式（与TcpMgr::slot_sent_data相同的帧头），走和socket收包相同的拆包路径
+void TcpReplayer::deliver(const CaptureFrame &frame)
+{
+    QByteArray wire;
+    QDataStream stream(&wire, QIODevice::WriteOnly);
+    stream.setVersion(QDataStream::Qt_6_9);
+    stream << frame.id << static_cast<quint16>(frame.body.size());
+    wire.append(frame.body);
+    _bytes += wire.size();
+
+    TcpMgr *tcp = TcpMgr::GetInstance().get();
+    tcp->_buffer.append(wire);
+    tcp->processBuffer();
+}
+
+void TcpReplayer::finish()
+{
+    const qint64 elapsedMs = qMax<qint64>(1, _clock.elapsed());
+    if (_speed > 0) {
+        qDebug() << "回放完成:" << _frames.size() << "帧," << _bytes << "字节, 耗时" << elapsedMs << "ms, 平均滞后"
+                 << _lateSumUs / _frames.size() << "us, 最大滞后" << _maxLateUs / 1000 << "ms";
+    } else {
+        qDebug() << "回放完成:" << _frames.size() << "帧," << _bytes << "字节, 耗时" << elapsedMs << "ms,"
+                 << _frames.size() * 1000 / elapsedMs << "帧/秒," << _bytes * 1000 / elapsedMs / 1024 << "KB/秒, 分"
+                 << _slices << "片";
+    }
+    emit sig_finished();
+}
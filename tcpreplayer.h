@@ -0,0 +1,46 @@
+#ifndef TCPREPLAYER_H
+#define TCPREPLAYER_H
+#include <QObject>
+#include <QTimer>
+#include <QElapsedTimer>
+#include "tcpcapture.h"
+
+/**
+ * @brief 抓包回放
+ * 把抓包文件里收到的帧按原始间隔（可加速）重新拼成线上字节流，交给TcpMgr的
+ * processBuffer/handleMsg处理，不经过socket。同一份抓包每次回放的报文顺序和内容都相同，
+ * 用于复现线上的消息组合并压测吞吐和界面响应。发出的帧只用于分析，不回放。
+ */
+class TcpReplayer : public QObject
+{
+    Q_OBJECT
+public:
+    explicit TcpReplayer(QObject *parent = nullptr);
+
+    // speed为倍速（1为原速），<=0表示全速
+    bool start(const QString &path, double speed);
+
+signals:
+    void sig_finished();
+
+private slots:
+    void onTick();
+
+private:
+    void deliver(const CaptureFrame &frame);
+    void finish();
+
+    QVector<CaptureFrame> _frames; // 只含收到的帧，时间从第一帧起算
+    int _next;                     // 下一帧的下标
+    double _speed;
+    QElapsedTimer _clock;
+    QTimer _timer;
+    qint64 _bytes;                 // 已回放的字节数
+    qint64 _lateSumUs;             // 按时回放时，实际交付相对计划时间的滞后总和
+    qint64 _maxLateUs;             // 最大滞后
+    int _slices;                   // 全速回放的分片数
+
+    static const int MAX_SPEED_SLICE_MS = 8; // 全速回放每片最多占用事件循环的时间，留出绘制的机会
+};
+
+#endif // TCPREPLAYER_H
@@ -0,0 +1,16 @@
+QT += testlib
+
+CONFIG += console
+CONFIG -= app_bundle
+
+TARGET = tst_chatlistbench
+
+include(../../baijiuchat.pri)
+include(../fixtures/fixtures.pri)
+
+SOURCES += \
+    tst_chatlistbench.cpp
+
+# 头像按原图打包，滚动时的解码开销和主程序默认构建一致
+RESOURCES += \
+    $$PWD/../../avatars.qrc
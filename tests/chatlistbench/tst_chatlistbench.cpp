@@ -0,0 +1,282 @@
+#include "chatlistwid.h"
+#include "chatfixture.h"
+#include <QtTest>
+#include <QRandomGenerator>
+#include <QScrollBar>
+#include <QStandardPaths>
+#include <algorithm>
+
+/**
+ * @brief 会话列表压测
+ * 用ChatFixture按固定种子生成1k/10k/100k/1M行数据，依次测量加载、排序、增改、
+ * 选中切换（固定1万行）、程序化滚动和内存。需要在offscreen平台下运行，结果用-o参数输出，见tools/list_bench.sh。
+ * BAIJIU_LIST_BENCH_SIZES=1000,10000 可以只跑部分规模。
+ */
+class tst_ChatListBench : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void cleanupTestCase();
+
+    void load_data() { addSizes(); }
+    void load();
+    void sort_data() { addSizes(); }
+    void sort();
+    void add_data() { addSizes(); }
+    void add();
+    void update_data() { addSizes(); }
+    void update();
+    void selectionChange();
+    void scroll_data() { addSizes(); }
+    void scroll();
+    void scrollWorstStep_data() { addSizes(); }
+    void scrollWorstStep();
+    void scrollPoolMisses_data() { addSizes(); }
+    void scrollPoolMisses();
+    void storeBytesPerRow_data() { addSizes(); }
+    void storeBytesPerRow();
+    void legacyBytesPerRow_data() { addSizes(); }
+    void legacyBytesPerRow();
+    void residentBytes_data() { addSizes(); }
+    void residentBytes();
+
+private:
+    // 固定时间基准，保证各次运行的数据逐字节相同
+    static QDateTime fixtureNow() { return QDateTime(QDate(2025, 5, 4), QTime(12, 0)); }
+    void addSizes();
+    const QVector<ChatItemData> &fixture(int rows);
+    // 估算同样的数据用QVector<ChatItemData>保存时占用的字节数
+    static qint64 legacyMemoryBytes(const QVector<ChatItemData> &items);
+    void reload(int rows);
+    qint64 scrollOnce(); // 从顶到底滚一遍，返回最慢一步的耗时（纳秒）
+
+    ChatListWid *m_list = nullptr;
+    QVector<ChatItemData> m_items;
+    int m_itemRows = 0;
+    int m_nextId = 0;
+
+    static const quint32 SEED = 20250504;     // 所有规模共用的种子
+    static const int MUTATION_OPS = 1000;     // 每轮增、改各执行的次数
+    static const int SCROLL_STEPS = 300;      // 滚动采样步数
+    static const int SELECTION_ROWS = 10000;  // 选中切换压测的列表规模
+    static const int SELECTION_STEPS = 100;   // 每轮按下方向键的次数
+};
+
+void tst_ChatListBench::initTestCase()
+{
+    // 本地库切到测试目录，不污染用户数据
+    QStandardPaths::setTestModeEnabled(true);
+    m_list = new ChatListWid;
+    m_list->resize(300, 600);
+    m_list->show();
+    QCoreApplication::processEvents();
+}
+
+void tst_ChatListBench::cleanupTestCase()
+{
+    delete m_list;
+    m_list = nullptr;
+}
+
+void tst_ChatListBench::addSizes()
+{
+    QTest::addColumn<int>("rows");
+    const QString sizes = qEnvironmentVariable("BAIJIU_LIST_BENCH_SIZES", "1000,10000,100000,1000000");
+    for (const QString &size : sizes.split(',', Qt::SkipEmptyParts)) {
+        if (size.toInt() > 0)
+            QTest::newRow(qPrintable(size)) << size.toInt();
+    }
+}
+
+// 只缓存最近一个规模的数据，1M行的数据不在各规模之间同时驻留
+const QVector<ChatItemData> &tst_ChatListBench::fixture(int rows)
+{
+    if (m_itemRows != rows) {
+        ChatFixtureOptions options;
+        options.count = rows;
+        options.seed = SEED;
+        options.now = fixtureNow();
+        m_items = ChatFixture::generate(options);
+        m_itemRows = rows;
+    }
+    return m_items;
+}
+
+// 每个用例都从同一份数据重新加载，前一个用例的增改不影响后面的结果
+void tst_ChatListBench::reload(int rows)
+{
+    m_list->loadChatItems(fixture(rows));
+    m_nextId = rows + 1;
+    QCoreApplication::processEvents();
+}
+
+// 整表加载（含排序、搜索索引投递、创建占位行）
+void tst_ChatListBench::load()
+{
+    QFETCH(int, rows);
+    const QVector<ChatItemData> &items = fixture(rows);
+    QBENCHMARK {
+        m_list->loadChatItems(items);
+    }
+}
+
+// 打乱行序后单独计时排序，打乱不能计入，所以只测一轮
+void tst_ChatListBench::sort()
+{
+    QFETCH(int, rows);
+    reload(rows);
+    QRandomGenerator rng(SEED);
+    std::shuffle(m_list->m_order.begin(), m_list->m_order.end(), rng);
+    QBENCHMARK_ONCE {
+        m_list->sortChatItems();
+    }
+}
+
+// 新增会话：时间随机，插入到中间位置；每轮MUTATION_OPS次
+void tst_ChatListBench::add()
+{
+    QFETCH(int, rows);
+    reload(rows);
+    const QVector<ChatItemData> &items = fixture(rows);
+    const QDateTime base = fixtureNow();
+    const int timeSpanMinutes = ChatFixtureOptions().timeSpanMinutes;
+    QRandomGenerator rng(SEED);
+    QBENCHMARK {
+        for (int i = 0; i < MUTATION_OPS; ++i) {
+            ChatItemData data = items[rng.bounded(int(items.size()))];
+            data.id = m_nextId++;
+            data.lastMessageTime = base.addSecs(-qint64(rng.bounded(timeSpanMinutes)) * 60);
+            m_list->addChatItem(data);
+        }
+    }
+}
+
+// 更新会话：一半原地改未读数，一半收到新消息移到顶部；每轮MUTATION_OPS次
+void tst_ChatListBench::update()
+{
+    QFETCH(int, rows);
+    reload(rows);
+    const QDateTime base = fixtureNow();
+    QRandomGenerator rng(SEED);
+    int seconds = 0;
+    QBENCHMARK {
+        for (int i = 0; i < MUTATION_OPS; ++i) {
+            const int row = rng.bounded(m_list->count());
+            ChatItemData data = m_list->getChatItemData(row);
+            data.unreadCount += 1;
+            if (i % 2)
+                data.lastMessageTime = base.addSecs(++seconds);
+            m_list->updateChatItem(row, data);
+        }
+    }
+}
+
+// 按住方向键连续切换选中：每次切换处理完事件（含重绘），每轮SELECTION_STEPS次
+void tst_ChatListBench::selectionChange()
+{
+    reload(SELECTION_ROWS);
+    m_list->setFocus();
+    m_list->setCurrentRow(0);
+    QCoreApplication::processEvents();
+    QBENCHMARK {
+        for (int i = 0; i < SELECTION_STEPS; ++i) {
+            if (m_list->currentRow() >= m_list->count() - 1)
+                m_list->setCurrentRow(0);
+            QTest::keyClick(m_list, Qt::Key_Down);
+            QCoreApplication::processEvents();
+        }
+    }
+}
+
+// 程序化滚动：从顶到底等距设置滚动条，每步处理完事件（含绘制）
+qint64 tst_ChatListBench::scrollOnce()
+{
+    QScrollBar *scrollBar = m_list->verticalScrollBar();
+    const int maximum = scrollBar->maximum();
+    qint64 worstNs = 0;
+    QElapsedTimer stepTimer;
+    for (int step = 0; step <= SCROLL_STEPS; ++step) {
+        stepTimer.start();
+        scrollBar->setValue(int(qint64(maximum) * step / SCROLL_STEPS));
+        QCoreApplication::processEvents();
+        worstNs = qMax(worstNs, stepTimer.nsecsElapsed());
+    }
+    scrollBar->setValue(0);
+    QCoreApplication::processEvents();
+    return worstNs;
+}
+
+// 每轮是一整遍SCROLL_STEPS+1步
+void tst_ChatListBench::scroll()
+{
+    QFETCH(int, rows);
+    reload(rows);
+    QBENCHMARK {
+        scrollOnce();
+    }
+}
+
+void tst_ChatListBench::scrollWorstStep()
+{
+    QFETCH(int, rows);
+    reload(rows);
+    QTest::setBenchmarkResult(scrollOnce() / 1e6, QTest::WalltimeMilliseconds);
+}
+
+// 滚一遍时回收池为空而新建控件的次数
+void tst_ChatListBench::scrollPoolMisses()
+{
+    QFETCH(int, rows);
+    reload(rows);
+    const int before = m_list->poolMisses();
+    scrollOnce();
+    QTest::setBenchmarkResult(m_list->poolMisses() - before, QTest::Events);
+}
+
+// 列式存储的估算内存
+void tst_ChatListBench::storeBytesPerRow()
+{
+    QFETCH(int, rows);
+    reload(rows);
+    const ChatItemStore &store = m_list->chatItemStore();
+    QTest::setBenchmarkResult(double(store.memoryBytes()) / qMax(1, store.size()), QTest::BytesAllocated);
+}
+
+// 每项独立持有三个字符串时的开销（不考虑隐式共享）
+qint64 tst_ChatListBench::legacyMemoryBytes(const QVector<ChatItemData> &items)
+{
+    qint64 bytes = items.capacity() * qint64(sizeof(ChatItemData));
+    for (const ChatItemData &item : items) {
+        bytes += (item.avatarPath.capacity() + item.name.capacity() + item.lastMessage.capacity())
+                     * qint64(sizeof(QChar)) + 3 * 24;
+    }
+    return bytes;
+}
+
+// 同样数据用旧的逐行结构存放时的估算内存，作为对照
+void tst_ChatListBench::legacyBytesPerRow()
+{
+    QFETCH(int, rows);
+    QTest::setBenchmarkResult(double(legacyMemoryBytes(fixture(rows))) / qMax(1, rows),
+                              QTest::BytesAllocated);
+}
+
+// 加载后进程常驻内存，只在Linux下可读
+void tst_ChatListBench::residentBytes()
+{
+    QFETCH(int, rows);
+    reload(rows);
+    QFile statm("/proc/self/statm");
+    if (!statm.open(QIODevice::ReadOnly))
+        QSKIP("没有/proc/self/statm");
+    const QList<QByteArray> fields = statm.readAll().split(' ');
+    if (fields.size() < 2)
+        QSKIP("/proc/self/statm格式不对");
+    QTest::setBenchmarkResult(fields[1].toLongLong() * 4096, QTest::BytesAllocated);
+}
+
+QTEST_MAIN(tst_ChatListBench)
+
+#include "tst_chatlistbench.moc"
@@ -0,0 +1,95 @@
+#include "chatfixture.h"
+#include <QRandomGenerator>
+#include <QStringList>
+#include <algorithm>
+
+QVector<ChatItemData> ChatFixture::generate(const ChatFixtureOptions &options)
+{
+    static const QStringList avatarPaths = {
+        ":/LogReg/avatars/avatar1.png",
+        ":/LogReg/avatars/avatar2.png",
+        ":/LogReg/avatars/avatar3.png",
+        ":/LogReg/avatars/avatar4.png",
+        ":/LogReg/avatars/avatar5.png",
+        ":/LogReg/avatars/avatar6.png",
+    };
+    static const QStringList surnames = {"赵","钱","孙","李","周","吴","郑","王","冯","陈","褚","卫","蒋","沈","韩","杨"};
+    static const QStringList givenNames = {"伟","芳","娜","秀英","敏","静","丽","强","磊","军","洋","勇","艳","杰","娟","涛"};
+    static const QStringList groupSuffixes = {"交流群","讨论组","粉丝群","亲友团","同学会","工作群","项目组","游戏群"};
+    static const QStringList messageTemplates = {
+        "你吃饭了吗？",
+        "在吗？有事找你",
+        "[图片]",
+        "[语音消息]",
+        "明天下午3点开会",
+        "这个需求什么时候能完成？",
+        "我马上到",
+        "周末一起出去玩吧",
+        "你看这个链接：https://example.com",
+        "😂😂😂",
+        "好的，没问题",
+        "我再考虑一下",
+        "谢谢！",
+        "你听说了吗？",
+        "最新版本已经发布",
+        "帮我带杯咖啡",
+        "晚上吃什么？",
+        "项目进度怎么样了？",
+        "这个bug怎么解决？",
+        "记得带身份证"
+    };
+
+    QRandomGenerator rng(options.seed);
+    const int total = qMax(0, options.count);
+    // 群聊数向下取整，其余都是个人聊天，保证名称数与总数一致
+    const int groupCount = int(qint64(total) * qBound(0, options.groupRatio, 100) / 100);
+    const int individualCount = total - groupCount;
+
+    // 预生成名称：前individualCount个是个人，之后是群聊
+    QStringList names;
+    names.reserve(total);
+    for (int i = 0; i < individualCount; ++i) {
+        names.append(surnames[rng.bounded(surnames.size())] + givenNames[rng.bounded(givenNames.size())]);
+    }
+    for (int i = 0; i < groupCount; ++i) {
+        names.append(surnames[rng.bounded(surnames.size())] + givenNames[rng.bounded(givenNames.size())] +
+                     "的" + groupSuffixes[rng.bounded(groupSuffixes.size())]);
+    }
+
+    QVector<ChatItemData> items;
+    items.reserve(total);
+    const QDateTime now = options.now.isValid() ? options.now : QDateTime::currentDateTime();
+    const int timeSpan = qMax(1, options.timeSpanMinutes);
+    for (int i = 0; i < total; ++i) {
+        ChatItemData item;
+        item.id = i + 1;
+        item.avatarPath = avatarPaths[i % avatarPaths.size()];
+        item.lastMessageTime = now.addSecs(-qint64(rng.bounded(timeSpan)) * 60);
+        item.name = names[i];
+        // 按生成顺序判断，群名后缀并不都带“群”字
+        item.isGroup = i >= individualCount;
+
+        // 生成最后一条消息：与原createTestData相同，单聊的预览按概率带发送者前缀
+        if (int(rng.bounded(100)) < options.senderProb && !item.isGroup && individualCount > 0) {
+            const QString sender = names[rng.bounded(individualCount)] + ": ";
+            item.lastMessage = sender + messageTemplates[rng.bounded(messageTemplates.size())];
+        } else {
+            item.lastMessage = messageTemplates[rng.bounded(messageTemplates.size())];
+        }
+
+        const int unreadProb = item.isGroup ? options.unreadProbGroup : options.unreadProbIndividual;
+        const int maxUnread = item.isGroup ? options.maxUnreadGroup : options.maxUnreadIndividual;
+        if (int(rng.bounded(100)) < unreadProb && maxUnread > 1) {
+            item.unreadCount = rng.bounded(1, maxUnread);
+        } else {
+            item.unreadCount = 0;
+        }
+
+        item.muted = int(rng.bounded(100)) < (item.isGroup ? options.muteProbGroup : options.muteProbIndividual);
+        item.isValid = true;
+        items.append(item);
+    }
+
+    std::shuffle(items.begin(), items.end(), rng);
+    return items;
+}
@@ -0,0 +1,34 @@
+#ifndef CHATFIXTURE_H
+#define CHATFIXTURE_H
+
+#include <QVector>
+#include <QDateTime>
+#include "chatitemdata.h"
+
+// 合成会话数据的参数，默认值即原先ChatListWid里写死的配置
+struct ChatFixtureOptions {
+    int count = 10000;                  // 总数据量
+    quint32 seed = 20250504;            // 随机种子，相同参数和种子生成完全相同的数据
+    int groupRatio = 40;                // 群聊占比（百分比），其余为个人聊天
+    int maxUnreadIndividual = 20;       // 个人聊天最大未读数
+    int maxUnreadGroup = 150;           // 群聊最大未读数
+    int muteProbIndividual = 10;        // 个人聊天静音概率（百分比）
+    int muteProbGroup = 30;             // 群聊静音概率（百分比）
+    int unreadProbIndividual = 30;      // 个人聊天有未读消息概率（百分比）
+    int unreadProbGroup = 60;           // 群聊有未读消息概率（百分比）
+    int senderProb = 50;                // 单聊预览带发送者前缀的概率（百分比），与原测试数据一致
+    int timeSpanMinutes = 43200;        // 最后消息时间分布在多少分钟内（默认30天）
+    QDateTime now;                      // 时间基准，为空时取当前时间
+};
+
+/**
+ * @brief 合成会话数据
+ * 会话列表压测和搜索压测的负载都从这里生成，所有随机数来自按种子构造的生成器
+ */
+class ChatFixture
+{
+public:
+    static QVector<ChatItemData> generate(const ChatFixtureOptions &options = ChatFixtureOptions());
+};
+
+#endif // CHATFIXTURE_H
@@ -0,0 +1,8 @@
+# 压测共用的合成数据，不进客户端
+INCLUDEPATH += $$PWD
+
+SOURCES += \
+    $$PWD/chatfixture.cpp
+
+HEADERS += \
+    $$PWD/chatfixture.h
@@ -0,0 +1,44 @@
+#include "messagefixture.h"
+#include <QRandomGenerator>
+#include <QStringList>
+
+QVector<MessageData> MessageFixture::generate(int chatId, int begin, int count, int total, qint64 newestMs)
+{
+    QVector<MessageData> page;
+    begin = qMax(0, begin);
+    const int end = qMin(total, begin + qMax(0, count));
+    page.reserve(qMax(0, end - begin));
+    for (int i = begin; i < end; ++i) {
+        page.append(generateOne(chatId, i, total, newestMs));
+    }
+    return page;
+}
+
+MessageData MessageFixture::generateOne(int chatId, int index, int total, qint64 newestMs)
+{
+    static const QStringList templates = {
+        "你吃饭了吗？",
+        "在吗？有事找你",
+        "明天下午3点开会，记得带上上周的评审材料，会议室在三楼东侧",
+        "好的，没问题",
+        "这个需求什么时候能完成？产品那边一直在催，最好这周之内能给个可以演示的版本",
+        "我马上到",
+        "周末一起出去玩吧",
+        "你看这个链接：https://example.com",
+        "😂😂😂",
+        "我再考虑一下",
+        "谢谢！",
+        "项目进度怎么样了？",
+        "这个bug怎么解决？我在本地复现了好几次，只有在列表滚动很快的时候才会出现，怀疑是控件复用的时候状态没有重置",
+        "记得带身份证",
+        "晚上吃什么？"
+    };
+
+    QRandomGenerator gen(quint32(chatId) * 2654435761u ^ quint32(index));
+    QString text = templates[gen.bounded(templates.size())];
+    // 偶尔拼接成长消息，覆盖多行换行
+    if (gen.bounded(10) == 0)
+        text += text;
+    const qint64 timeMs = newestMs - qint64(total - 1 - index) * 60 * 1000;
+    return MessageData((qint64(chatId) << 32) | quint32(index), chatId, gen.bounded(2) == 0, text, timeMs);
+}
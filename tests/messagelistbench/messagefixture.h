@@ -0,0 +1,22 @@
+#ifndef MESSAGEFIXTURE_H
+#define MESSAGEFIXTURE_H
+
+#include <QVector>
+#include "messagedata.h"
+
+/**
+ * @brief 合成消息历史
+ * 由会话ID和序号确定地生成消息，同一位置每次生成的内容相同，任意位置都能直接生成；
+ * 压测先用它把会话历史写入本地库
+ */
+class MessageFixture
+{
+public:
+    // 会话共total条历史中序号[begin, begin + count)的消息，最后一条的时间为newestMs，相邻消息间隔一分钟
+    static QVector<MessageData> generate(int chatId, int begin, int count, int total, qint64 newestMs);
+
+private:
+    static MessageData generateOne(int chatId, int index, int total, qint64 newestMs);
+};
+
+#endif // MESSAGEFIXTURE_H
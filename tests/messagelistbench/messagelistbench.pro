@@ -0,0 +1,15 @@
+QT += testlib
+
+CONFIG += console
+CONFIG -= app_bundle
+
+TARGET = tst_messagelistbench
+
+include(../../baijiuchat.pri)
+
+SOURCES += \
+    messagefixture.cpp \
+    tst_messagelistbench.cpp
+
+HEADERS += \
+    messagefixture.h
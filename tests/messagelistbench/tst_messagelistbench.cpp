@@ -0,0 +1,114 @@
+#include "messagelistview.h"
+#include "messagedelegate.h"
+#include "messagemodel.h"
+#include "messagestore.h"
+#include "localdb.h"
+#include "messagefixture.h"
+#include <QtTest>
+#include <QScrollBar>
+#include <QStandardPaths>
+
+/**
+ * @brief 消息列表滚动压测
+ * 在百万条消息的压测会话上持续向上翻历史，测量每步滚动（含分页加载和绘制）的耗时和排版缓存命中。
+ * 消息由MessageFixture合成后先写入测试目录下的本地库，分页从SQLite读取，与真实会话走同一条路径。
+ * 需要在offscreen平台下运行，结果用-o参数输出。
+ */
+class tst_MessageListBench : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void init();
+    void cleanup();
+
+    void scrollUp();
+    void layoutCacheMisses();
+
+private:
+    static void seedMessages(int chatId, int count); // 经写后队列把合成消息写入本地库，已写过时跳过
+    int scrollSteps(int steps); // 向上滚steps步，每步处理完事件，返回实际滚过的步数
+
+    MessageListView *m_view = nullptr;
+
+    static const int CHAT_ID = 1;               // 压测会话
+    static const int MESSAGE_COUNT = 1000000;   // 压测会话的消息数
+    static const int STEPS = 100; // 每轮滚动的步数
+    static const int STEP = 120;  // 每步滚动的像素，与手动快速滚动相当
+};
+
+void tst_MessageListBench::initTestCase()
+{
+    // 本地库切到测试目录，不污染用户数据；已写过的库直接复用
+    QStandardPaths::setTestModeEnabled(true);
+    seedMessages(CHAT_ID, MESSAGE_COUNT);
+    QCOMPARE(MessageStore::GetInstance()->messageCount(CHAT_ID), int(MESSAGE_COUNT));
+}
+
+void tst_MessageListBench::seedMessages(int chatId, int count)
+{
+    auto db = LocalDb::GetInstance();
+    if (db->messageCount(chatId) >= count)
+        return;
+    QElapsedTimer timer;
+    timer.start();
+    const qint64 newestMs = QDateTime(QDate(2025, 5, 4), QTime(12, 0)).toMSecsSinceEpoch();
+    const int PAGE = 10000;
+    for (int begin = 0; begin < count; begin += PAGE) {
+        for (const MessageData &message : MessageFixture::generate(chatId, begin, PAGE, count, newestMs)) {
+            db->enqueueMessage(message);
+        }
+    }
+    db->flush();
+    qDebug() << "压测消息落盘:" << count << "条, 耗时" << timer.elapsed() << "ms";
+}
+
+// 每个用例都从会话底部、空的排版缓存开始
+void tst_MessageListBench::init()
+{
+    m_view = new MessageListView;
+    m_view->resize(400, 700);
+    m_view->show();
+    m_view->openConversation(CHAT_ID);
+    QCoreApplication::processEvents();
+}
+
+void tst_MessageListBench::cleanup()
+{
+    delete m_view;
+    m_view = nullptr;
+}
+
+int tst_MessageListBench::scrollSteps(int steps)
+{
+    QScrollBar *bar = m_view->verticalScrollBar();
+    auto model = static_cast<MessageModel *>(m_view->model());
+    int done = 0;
+    for (; done < steps && (bar->value() > 0 || model->canLoadOlder()); ++done) {
+        bar->setValue(bar->value() - STEP);
+        QCoreApplication::processEvents();
+    }
+    return done;
+}
+
+// 每轮STEPS步；百万条消息足够所有轮次一直向上翻
+void tst_MessageListBench::scrollUp()
+{
+    QBENCHMARK {
+        QCOMPARE(scrollSteps(STEPS), int(STEPS));
+    }
+}
+
+// 翻一轮时排版缓存的未命中次数，即新排版的气泡数
+void tst_MessageListBench::layoutCacheMisses()
+{
+    auto delegate = static_cast<MessageDelegate *>(m_view->itemDelegate());
+    const int before = delegate->misses();
+    QCOMPARE(scrollSteps(STEPS), int(STEPS));
+    QTest::setBenchmarkResult(delegate->misses() - before, QTest::Events);
+}
+
+QTEST_MAIN(tst_MessageListBench)
+
+#include "tst_messagelistbench.moc"
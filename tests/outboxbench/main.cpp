@@ -0,0 +1,36 @@
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QStandardPaths>
+#include "outboxdriver.h"
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication a(argc, argv);
+    QCoreApplication::setApplicationName("outboxbench");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("发件箱吞吐压测：登录聊天服务器后只通过enqueue()投递消息，统计速率和fsync批量");
+    parser.addHelpOption();
+    QCommandLineOption hostOption("host", "聊天服务器地址", "host", "127.0.0.1");
+    QCommandLineOption portOption("port", "聊天服务器端口", "port", "8090");
+    QCommandLineOption uidOption("uid", "登录的用户id，发件箱日志按用户分文件", "uid", "1");
+    QCommandLineOption countOption("count", "投递的消息数", "count", "100000");
+    QCommandLineOption chatOption("chat", "消息发往的会话id", "id", "1");
+    parser.addOptions({hostOption, portOption, uidOption, countOption, chatOption});
+    parser.process(a);
+
+    // 发件箱日志和本地库放在测试目录，不碰用户数据；日志跨次保留，消息id不回退，替身服务器不会当成重复
+    QStandardPaths::setTestModeEnabled(true);
+
+    OutboxDriver driver(parser.value(countOption).toInt(), parser.value(chatOption).toInt());
+    QObject::connect(&driver, &OutboxDriver::finished, &a, &QCoreApplication::exit, Qt::QueuedConnection);
+
+    ServerInfo server;
+    server.Host = parser.value(hostOption);
+    server.Port = parser.value(portOption);
+    server.Token = "bench";
+    server.Uid = parser.value(uidOption).toInt();
+    driver.start(server);
+
+    return a.exec();
+}
@@ -0,0 +1,13 @@
+CONFIG += console
+CONFIG -= app_bundle
+
+TARGET = outboxbench
+
+include(../../baijiuchat.pri)
+
+SOURCES += \
+    main.cpp \
+    outboxdriver.cpp
+
+HEADERS += \
+    outboxdriver.h
@@ -0,0 +1,91 @@
+#include "outboxdriver.h"
+#include "outboxmgr.h"
+#include "tcpmgr.h"
+#include <QDateTime>
+#include <QDebug>
+
+OutboxDriver::OutboxDriver(int count, int chatId, QObject *parent)
+    : QObject(parent), _total(count), _remaining(count), _chatId(chatId),
+      _syncsBefore(0), _syncedBefore(0), _compactionsBefore(0)
+{
+    // 满了以后按确认的节奏补，1ms足够跟上确认
+    _fillTimer.setInterval(1);
+    connect(&_fillTimer, &QTimer::timeout, this, &OutboxDriver::fill);
+    connect(TcpMgr::GetInstance().get(), &TcpMgr::sig_con_success, this, &OutboxDriver::onConnected);
+    connect(TcpMgr::GetInstance().get(), &TcpMgr::sig_switch_chatdlg, this, &OutboxDriver::onLoggedIn);
+    connect(TcpMgr::GetInstance().get(), &TcpMgr::sig_login_failed, this, [this](int error) {
+        qDebug() << "聊天登录失败:" << error;
+        emit finished(1);
+    });
+    // 登录前的网络错误（如连接被拒绝）和压测中途断线都直接结束，没有重连
+    connect(TcpMgr::GetInstance().get(), &TcpMgr::sig_network_error, this, [this](int, const QString &error) {
+        if (_fillTimer.isActive())
+            return;
+        qDebug() << "连接聊天服务器失败:" << error;
+        emit finished(1);
+    });
+    connect(TcpMgr::GetInstance().get(), &TcpMgr::sig_disconnected, this, [this]() {
+        if (!_fillTimer.isActive())
+            return;
+        qDebug() << "压测中与聊天服务器断开, 未入队" << _remaining << "条, 未确认"
+                 << OutboxMgr::GetInstance()->pendingCount() << "条";
+        emit finished(1);
+    });
+}
+
+void OutboxDriver::start(const ServerInfo &server)
+{
+    _server = server;
+    TcpMgr::GetInstance()->slot_tcp_connect(server);
+}
+
+void OutboxDriver::onConnected(bool success)
+{
+    if (!success) {
+        qDebug() << "连接聊天服务器失败:" << _server.Host << _server.Port;
+        emit finished(1);
+        return;
+    }
+    QJsonObject jsonObj;
+    jsonObj["uid"] = _server.Uid;
+    jsonObj["token"] = _server.Token;
+    TcpMgr::GetInstance()->sendJsonData(ReqId::ID_CHAT_LOGIN, jsonObj);
+}
+
+// 登录成功时TcpMgr已打开该用户的发件箱并开始重发上次遗留的消息
+void OutboxDriver::onLoggedIn()
+{
+    auto outbox = OutboxMgr::GetInstance();
+    if (outbox->pendingCount() > 0)
+        qDebug() << "发件箱有" << outbox->pendingCount() << "条上次遗留的消息，一并计入";
+    _syncsBefore = outbox->syncCount();
+    _syncedBefore = outbox->syncedRecordCount();
+    _compactionsBefore = outbox->compactionCount();
+    qDebug() << "发件箱压测开始:" << _total << "条";
+    _clock.start();
+    _fillTimer.start();
+    fill();
+}
+
+void OutboxDriver::fill()
+{
+    auto outbox = OutboxMgr::GetInstance();
+    while (_remaining > 0) {
+        const QString text = QString("压测消息%1").arg(_total - _remaining);
+        if (outbox->enqueue(_chatId, text, QDateTime::currentMSecsSinceEpoch()) < 0)
+            break; // 满了，等下一轮
+        --_remaining;
+    }
+    if (_remaining > 0 || outbox->pendingCount() > 0)
+        return;
+
+    _fillTimer.stop();
+    const qint64 elapsed = qMax<qint64>(1, _clock.elapsed());
+    const qint64 syncs = outbox->syncCount() - _syncsBefore;
+    const qint64 synced = outbox->syncedRecordCount() - _syncedBefore;
+    qDebug() << "发件箱压测完成:" << _total << "条, 耗时" << elapsed << "ms,"
+             << _total * 1000 / elapsed << "条/秒, fsync" << syncs << "次, 平均每次"
+             << (syncs > 0 ? synced / syncs : 0) << "条, 压缩"
+             << outbox->compactionCount() - _compactionsBefore << "次";
+    emit finished(0);
+}
@@ -0,0 +1,41 @@
+#ifndef OUTBOXDRIVER_H
+#define OUTBOXDRIVER_H
+
+#include <QObject>
+#include <QTimer>
+#include <QElapsedTimer>
+#include "global.h"
+
+/**
+ * @brief 发件箱压测驱动
+ * 直接登录聊天服务器（一般是本地替身服务器），之后只通过OutboxMgr::enqueue()尽快投递count条消息，
+ * 发件箱满时等确认腾出空间再继续；全部确认后输出速率和fsync、压缩统计。
+ */
+class OutboxDriver : public QObject
+{
+    Q_OBJECT
+public:
+    OutboxDriver(int count, int chatId, QObject *parent = nullptr);
+
+    void start(const ServerInfo &server);
+
+signals:
+    void finished(int exitCode);
+
+private:
+    void onConnected(bool success);
+    void onLoggedIn();
+    void fill();            // 入队到发件箱满为止，全部确认后输出结果
+
+    ServerInfo _server;
+    int _total;
+    int _remaining;         // 还未入队的条数
+    int _chatId;            // 压测消息发往的会话
+    qint64 _syncsBefore;    // 开始时的统计，只输出本次压测的增量
+    qint64 _syncedBefore;
+    int _compactionsBefore;
+    QTimer _fillTimer;
+    QElapsedTimer _clock;
+};
+
+#endif // OUTBOXDRIVER_H
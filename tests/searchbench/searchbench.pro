@@ -0,0 +1,12 @@
+QT += testlib
+
+CONFIG += console
+CONFIG -= app_bundle
+
+TARGET = tst_searchbench
+
+include(../../baijiuchat.pri)
+include(../fixtures/fixtures.pri)
+
+SOURCES += \
+    tst_searchbench.cpp
@@ -0,0 +1,93 @@
+#include "chatsearchindex.h"
+#include "chatfixture.h"
+#include "pinyintable.h"
+#include <QtTest>
+
+/**
+ * @brief 会话搜索索引压测
+ * 用ChatFixture按固定种子生成10万个会话（名称来自姓氏和名字表），测量建索引耗时、
+ * 索引内存、拼音键数、内嵌拼音表的大小，以及汉字、全拼、首字母几类查询的耗时。结果用-o参数输出。
+ */
+class tst_SearchBench : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+
+    void build();
+    void bytesPerDoc();
+    void pinyinKeys();
+    void pinyinTableBytes();
+    void query_data();
+    void query();
+
+private:
+    QVector<SearchDoc> m_docs;
+    ChatSearchIndex m_index;
+
+    static const int DOC_COUNT = 100000;
+    static const int LIMIT = 50; // 与搜索框一次展示的条数一致
+};
+
+void tst_SearchBench::initTestCase()
+{
+    ChatFixtureOptions options;
+    options.count = DOC_COUNT;
+    options.now = QDateTime(QDate(2025, 5, 4), QTime(12, 0)); // 固定时间基准，保证数据逐字节相同
+    const QVector<ChatItemData> items = ChatFixture::generate(options);
+    m_docs.reserve(items.size());
+    for (const ChatItemData &item : items) {
+        m_docs.append(SearchDoc{item.id, item.name, item.lastMessage, item.lastMessageTime.toMSecsSinceEpoch()});
+    }
+    m_index.build(m_docs);
+}
+
+// 整表重建，含每个名称的拼音全拼和首字母
+void tst_SearchBench::build()
+{
+    ChatSearchIndex index;
+    QBENCHMARK {
+        index.build(m_docs);
+    }
+    QCOMPARE(index.size(), int(m_docs.size()));
+}
+
+void tst_SearchBench::bytesPerDoc()
+{
+    QTest::setBenchmarkResult(double(m_index.memoryBytes()) / qMax(1, m_index.size()), QTest::BytesAllocated);
+}
+
+void tst_SearchBench::pinyinKeys()
+{
+    QTest::setBenchmarkResult(m_index.pinyinKeyCount(), QTest::Events);
+}
+
+// 内嵌拼音表，与会话数无关
+void tst_SearchBench::pinyinTableBytes()
+{
+    QTest::setBenchmarkResult(PinyinTable::memoryBytes(), QTest::BytesAllocated);
+}
+
+void tst_SearchBench::query_data()
+{
+    QTest::addColumn<QString>("query");
+    QTest::newRow("hanzi_single") << QString("王");
+    QTest::newRow("hanzi_name") << QString("王伟");
+    QTest::newRow("full_pinyin") << QString("wangwei");
+    QTest::newRow("initials") << QString("ww");
+    QTest::newRow("preview") << QString("开会");
+    QTest::newRow("no_match") << QString("zzzzzz");
+}
+
+void tst_SearchBench::query()
+{
+    QFETCH(QString, query);
+    QBENCHMARK {
+        m_index.search(query, LIMIT);
+    }
+}
+
+QTEST_MAIN(tst_SearchBench)
+
+#include "tst_searchbench.moc"
@@ -0,0 +1,16 @@
+QT += testlib
+
+CONFIG += console
+CONFIG -= app_bundle
+
+TARGET = tst_stylebench
+
+include(../../baijiuchat.pri)
+
+SOURCES += \
+    tst_stylebench.cpp
+
+# legacy.qss是换成代理样式之前的全局样式表，只用作对照
+RESOURCES += \
+    $$PWD/../../avatars.qrc \
+    stylebench.qrc
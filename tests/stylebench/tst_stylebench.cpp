@@ -0,0 +1,74 @@
+#include "chatitemwidget.h"
+#include "logindialog.h"
+#include "registerdialog.h"
+#include "thememgr.h"
+#include <QtTest>
+#include <QApplication>
+
+/**
+ * @brief 样式压测
+ * 对比代理样式和旧的全局QSS下，一批会话项加登录、注册页的构造和polish耗时。
+ * 结果用-o参数输出，见tools/style_bench.sh。
+ */
+class tst_StyleBench : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void constructAndPolish_data();
+    void constructAndPolish();
+
+private:
+    static void buildAndPolish(int itemCount);
+
+    QString m_legacyQss;
+
+    static const int ITEM_COUNT = 200;
+};
+
+void tst_StyleBench::initTestCase()
+{
+    ThemeMgr::GetInstance()->install(qApp, Theme::Light);
+    QFile qss(":/stylebench/legacy.qss");
+    QVERIFY2(qss.open(QFile::ReadOnly), "打开legacy.qss失败");
+    m_legacyQss = QString::fromUtf8(qss.readAll());
+}
+
+void tst_StyleBench::constructAndPolish_data()
+{
+    QTest::addColumn<bool>("legacyQss");
+    QTest::newRow("proxy") << false;
+    QTest::newRow("legacy_qss") << true;
+}
+
+// 构造一批会话项和登录、注册页并强制polish
+void tst_StyleBench::buildAndPolish(int itemCount)
+{
+    QWidget host;
+    for (int i = 0; i < itemCount; ++i) {
+        ChatItemData data(i, ":/LogReg/avatars/default_avatar.png", QString("会话%1").arg(i),
+                          QString("消息预览%1").arg(i), QDateTime::currentDateTime(), i % 5, i % 7 == 0);
+        new ChatItemWidget(data, &host);
+    }
+    LoginDialog *login = new LoginDialog(&host);
+    RegisterDialog *reg = new RegisterDialog(&host);
+    host.ensurePolished(); // 递归polish所有子控件
+    login->ensurePolished();
+    reg->ensurePolished();
+}
+
+void tst_StyleBench::constructAndPolish()
+{
+    QFETCH(bool, legacyQss);
+    qApp->setStyleSheet(legacyQss ? m_legacyQss : QString());
+    buildAndPolish(ITEM_COUNT); // 预热：ui资源、字体等一次性开销不计入
+    QBENCHMARK {
+        buildAndPolish(ITEM_COUNT);
+    }
+    qApp->setStyleSheet(QString());
+}
+
+QTEST_MAIN(tst_StyleBench)
+
+#include "tst_stylebench.moc"
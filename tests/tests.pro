@@ -0,0 +1,10 @@
+# 压测目标，与主程序分开构建：qmake tests/tests.pro && make
+# 各目标复用根目录的baijiuchat.pri；QtTest目标的结果用-o参数输出，运行方式见tools/下的脚本
+TEMPLATE = subdirs
+
+SUBDIRS += \
+    chatlistbench \
+    messagelistbench \
+    outboxbench \
+    searchbench \
+    stylebench
@@ -0,0 +1,46 @@
+#include "textlayoutcache.h"
+#include <QGuiApplication>
+#include <QFontMetrics>
+#include <QScreen>
+
+TextLayoutCache::TextLayoutCache() : _cache(MAX_ENTRIES), _hits(0), _misses(0)
+{
+    // 应用字体变化
+    connect(qApp, &QGuiApplication::fontChanged, this, &TextLayoutCache::clear);
+    // DPI变化会改变字体度量
+    const QList<QScreen*> screens = QGuiApplication::screens();
+    for (QScreen *screen : screens) {
+        watchScreen(screen);
+    }
+    connect(qApp, &QGuiApplication::screenAdded, this, &TextLayoutCache::watchScreen);
+}
+
+TextLayoutCache::~TextLayoutCache()
+{
+}
+
+QString TextLayoutCache::elidedText(const QString &text, const QFont &font, int width, Qt::TextElideMode mode)
+{
+    ElideKey key{text, font, width, int(mode)};
+    if (QString *cached = _cache.object(key)) {
+        ++_hits;
+        return *cached;
+    }
+
+    ++_misses;
+    QFontMetrics metrics(font);
+    QString elided = metrics.elidedText(text, mode, width);
+    _cache.insert(key, new QString(elided));
+    return elided;
+}
+
+void TextLayoutCache::clear()
+{
+    _cache.clear();
+}
+
+void TextLayoutCache::watchScreen(QScreen *screen)
+{
+    connect(screen, &QScreen::logicalDotsPerInchChanged, this, &TextLayoutCache::clear);
+    connect(screen, &QScreen::physicalDotsPerInchChanged, this, &TextLayoutCache::clear);
+}
@@ -0,0 +1,60 @@
+#ifndef TEXTLAYOUTCACHE_H
+#define TEXTLAYOUTCACHE_H
+#include <QObject>
+#include <QCache>
+#include <QFont>
+#include <QString>
+#include "singleton.h"
+
+class QScreen;
+
+// 省略文本缓存的键：文本、字体、宽度和省略方式共同决定排版结果
+struct ElideKey {
+    QString text;
+    QFont font;
+    int width;
+    int mode;
+
+    bool operator==(const ElideKey &other) const
+    {
+        return width == other.width && mode == other.mode
+               && text == other.text && font == other.font;
+    }
+};
+
+inline size_t qHash(const ElideKey &key, size_t seed = 0)
+{
+    return qHashMulti(seed, key.text, key.font, key.width, key.mode);
+}
+
+/**
+ * @brief 全局文本排版缓存
+ * 会话行反复显示时直接取省略后的文本，不再重新测量和排版；
+ * 字体或屏幕DPI变化时整体失效，容量满后按最近最少使用淘汰。
+ */
+class TextLayoutCache : public QObject, public Singleton<TextLayoutCache>,
+                        public std::enable_shared_from_this<TextLayoutCache>
+{
+    Q_OBJECT
+public:
+    friend class Singleton<TextLayoutCache>;
+    ~TextLayoutCache();
+    // 获取省略后的文本，命中缓存时不做任何排版
+    QString elidedText(const QString &text, const QFont &font, int width,
+                       Qt::TextElideMode mode = Qt::ElideRight);
+    // 清空缓存
+    void clear();
+    int hits() const { return _hits; }
+    int misses() const { return _misses; }
+
+private:
+    TextLayoutCache();
+    void watchScreen(QScreen *screen);
+
+    static const int MAX_ENTRIES = 4096; // 最多缓存的文本条数
+    QCache<ElideKey, QString> _cache;
+    int _hits;
+    int _misses;
+};
+
+#endif // TEXTLAYOUTCACHE_H
@@ -0,0 +1,186 @@
+#include "thememgr.h"
+#include "baijiustyle.h"
+#include <QApplication>
+#include <QWidget>
+
+ThemeMgr::ThemeMgr() : _theme(Theme::Light), _colors(colorsFor(Theme::Light)), _installed(false)
+{
+    rebuildTextPalettes();
+}
+
+ThemeMgr::~ThemeMgr()
+{
+}
+
+ThemeColors ThemeMgr::colorsFor(Theme theme)
+{
+    ThemeColors c;
+    if (theme == Theme::Dark) {
+        c.window = QColor("#1F1F23");
+        c.surface = QColor("#1F1F23");
+        c.panel = QColor("#26262B");
+        c.text = QColor("#E6E6E6");
+        c.textDim = QColor("#A8A8A8");
+        c.textFaint = QColor("#808080");
+        c.border = QColor("#34343A");
+        c.accent = QColor("#6E6ED8");
+        c.accentText = QColor(Qt::white);
+        c.hover = QColor("#303036");
+        c.button = QColor("#7A62CC");
+        c.buttonHover = QColor("#8A70E0");
+        c.buttonPressed = QColor("#6A52BC");
+        c.buttonText = QColor(Qt::white);
+        c.flatHover = QColor(255, 255, 255, 20);
+        c.toolHover = QColor("#2C3A4A");
+        c.toolPressed = QColor("#34506C");
+        c.scrollTrack = QColor("#2A2A30");
+        c.scrollHandle = QColor("#55555C");
+        c.scrollHandleHover = QColor("#707078");
+        c.badge = QColor("#E5533D");
+        c.badgeSubtle = QColor("#5A5A60");
+        c.badgeText = QColor(Qt::white);
+        c.bubbleIn = QColor("#2E2E34");
+        c.bubbleInText = QColor("#E6E6E6");
+        c.tipNormal = QColor("#5CC45C");
+        c.tipError = QColor("#FF6B6B");
+        return c;
+    }
+    // 浅色主题即原QSS里的色值
+    c.window = QColor("#F9F9F9");
+    c.surface = QColor("#F9F9F9");
+    c.panel = QColor(Qt::white);
+    c.text = QColor("#333333");
+    c.textDim = QColor("#666666");
+    c.textFaint = QColor("#888888");
+    c.border = QColor("#EEEEEE");
+    c.accent = QColor("#A2A2FE");
+    c.accentText = QColor(Qt::white);
+    c.hover = QColor("#F0F0F0");
+    c.button = QColor("#B399FF");
+    c.buttonHover = QColor("#A280FF");
+    c.buttonPressed = QColor("#8F66FF");
+    c.buttonText = QColor(Qt::black);
+    c.flatHover = QColor(0, 0, 0, 13);
+    c.toolHover = QColor("#E3F2FD");
+    c.toolPressed = QColor("#BBDEFB");
+    c.scrollTrack = QColor("#F5F5F5");
+    c.scrollHandle = QColor("#C0C0C0");
+    c.scrollHandleHover = QColor("#A0A0A0");
+    c.badge = QColor("#F74C31");
+    c.badgeSubtle = QColor("#C7C7C7");
+    c.badgeText = QColor(Qt::white);
+    c.bubbleIn = QColor(Qt::white);
+    c.bubbleInText = QColor("#333333");
+    c.tipNormal = QColor(Qt::green);
+    c.tipError = QColor(Qt::red);
+    return c;
+}
+
+// 应用级调色板：未设置themeRole的控件都从这里继承
+QPalette ThemeMgr::appPalette() const
+{
+    QPalette palette = QApplication::style()->standardPalette();
+    palette.setColor(QPalette::Window, _colors.window);
+    palette.setColor(QPalette::WindowText, _colors.text);
+    palette.setColor(QPalette::Text, _colors.text);
+    palette.setColor(QPalette::PlaceholderText, _colors.textFaint);
+    palette.setColor(QPalette::Button, _colors.button);
+    palette.setColor(QPalette::ButtonText, _colors.buttonText);
+    palette.setColor(QPalette::Highlight, _colors.accent);
+    palette.setColor(QPalette::HighlightedText, _colors.accentText);
+    palette.setColor(QPalette::ToolTipBase, _colors.panel);
+    palette.setColor(QPalette::ToolTipText, _colors.text);
+    if (_theme == Theme::Dark) {
+        // 深色主题下输入框等使用默认Base的控件也要变暗
+        palette.setColor(QPalette::Base, _colors.panel);
+        palette.setColor(QPalette::AlternateBase, _colors.surface);
+    }
+    return palette;
+}
+
+void ThemeMgr::rebuildTextPalettes()
+{
+    const QColor colors[TEXT_ROLE_COUNT] = {
+        _colors.text,
+        _colors.textDim,
+        _colors.textFaint,
+        _colors.accentText,
+        QColor(_colors.accentText.red(), _colors.accentText.green(), _colors.accentText.blue(), 204),
+    };
+    for (int i = 0; i < TEXT_ROLE_COUNT; ++i) {
+        QPalette palette;
+        palette.setColor(QPalette::WindowText, colors[i]);
+        _textPalettes[i] = palette;
+    }
+}
+
+void ThemeMgr::install(QApplication *app, Theme theme)
+{
+    QElapsedTimer timer;
+    timer.start();
+    _theme = theme;
+    _colors = colorsFor(theme);
+    rebuildTextPalettes();
+    app->setStyle(new BaijiuStyle()); // QApplication接管样式对象
+    app->setPalette(appPalette());
+    _installed = true;
+    qDebug() << "安装主题样式耗时" << timer.nsecsElapsed() / 1000 << "us";
+}
+
+// 只换调色板：应用调色板的变化由Qt逐个发PaletteChange并重绘，
+// 带themeRole的控件重新解析一次颜色，样式本身不需要unpolish/polish
+void ThemeMgr::setTheme(Theme theme)
+{
+    if (theme == _theme || !_installed)
+        return;
+    QElapsedTimer timer;
+    timer.start();
+    _theme = theme;
+    _colors = colorsFor(theme);
+    rebuildTextPalettes();
+    QApplication::setPalette(appPalette());
+    int themed = 0;
+    const QWidgetList widgets = QApplication::allWidgets();
+    for (QWidget *widget : widgets) {
+        if (widget->property("themeRole").isValid() || widget->property("state").isValid()) {
+            applyRole(widget);
+            ++themed;
+        }
+    }
+    emit sig_theme_changed(theme);
+    qDebug() << "切换主题耗时" << timer.nsecsElapsed() / 1000 << "us,"
+             << widgets.size() << "个控件," << themed << "个按角色重设调色板";
+}
+
+void ThemeMgr::toggleTheme()
+{
+    setTheme(_theme == Theme::Light ? Theme::Dark : Theme::Light);
+}
+
+void ThemeMgr::applyRole(QWidget *widget) const
+{
+    const QByteArray role = widget->property("themeRole").toByteArray();
+    const QByteArray state = widget->property("state").toByteArray();
+    if (role.isEmpty() && state.isEmpty())
+        return;
+
+    QPalette palette = widget->palette();
+    if (role == "surface") {
+        palette.setColor(QPalette::Window, _colors.surface);
+        palette.setColor(QPalette::Base, _colors.surface);
+    } else if (role == "chatList") {
+        palette.setColor(QPalette::Base, _colors.panel);
+    } else if (role == "tipError") {
+        palette.setColor(QPalette::WindowText, _colors.tipError);
+    } else if (role == "badge" || role == "badgeSubtle") {
+        palette.setColor(QPalette::Window, role == "badge" ? _colors.badge : _colors.badgeSubtle);
+        palette.setColor(QPalette::WindowText, _colors.badgeText);
+    }
+    // 登录、注册、重置页的提示文字
+    if (state == "normal") {
+        palette.setColor(QPalette::WindowText, _colors.tipNormal);
+    } else if (state == "error") {
+        palette.setColor(QPalette::WindowText, _colors.tipError);
+    }
+    widget->setPalette(palette);
+}
@@ -0,0 +1,96 @@
+#ifndef THEMEMGR_H
+#define THEMEMGR_H
+#include <QObject>
+#include <QColor>
+#include <QPalette>
+#include "singleton.h"
+
+class QApplication;
+
+enum class Theme {
+    Light,
+    Dark,
+};
+
+// 一套主题的全部颜色，原先散落在QSS和各控件里的色值都收拢到这里
+struct ThemeColors {
+    QColor window;          // 窗口、对话框背景
+    QColor surface;         // 列表、消息区、输入框背景
+    QColor panel;           // 会话列表背景
+    QColor text;            // 正文
+    QColor textDim;         // 消息预览
+    QColor textFaint;       // 时间、静音等次要信息
+    QColor border;          // 分隔线
+    QColor accent;          // 选中项、自己的消息气泡
+    QColor accentText;      // 选中项上的文字
+    QColor hover;           // 列表项悬停
+    QColor button;          // 按钮
+    QColor buttonHover;
+    QColor buttonPressed;
+    QColor buttonText;
+    QColor flatHover;       // 无边框按钮悬停
+    QColor toolHover;       // 工具按钮悬停
+    QColor toolPressed;     // 工具按钮按下、选中
+    QColor scrollTrack;     // 细滚动条悬停时的轨道
+    QColor scrollHandle;
+    QColor scrollHandleHover;
+    QColor badge;           // 分区按钮上的未读角标
+    QColor badgeSubtle;     // 会话项上的未读数
+    QColor badgeText;
+    QColor bubbleIn;        // 对方的消息气泡
+    QColor bubbleInText;
+    QColor tipNormal;       // 提示文字
+    QColor tipError;        // 错误提示文字
+};
+
+/**
+ * @brief 主题服务
+ * 启动时安装一次代理样式和应用调色板，之后不再使用全局QSS：
+ * 控件外观由BaijiuStyle绘制，颜色由动态属性themeRole/state在polish时解析成调色板。
+ * 切换主题只更新调色板并重绘，不会重新polish整棵控件树。
+ */
+class ThemeMgr : public QObject, public Singleton<ThemeMgr>,
+                 public std::enable_shared_from_this<ThemeMgr>
+{
+    Q_OBJECT
+public:
+    friend class Singleton<ThemeMgr>;
+    ~ThemeMgr();
+
+    // 会话项文字的调色板
+    enum TextRole {
+        TEXT_NAME,
+        TEXT_MESSAGE,
+        TEXT_TIME,
+        TEXT_SELECTED,
+        TEXT_SELECTED_DIM,
+        TEXT_ROLE_COUNT
+    };
+
+    // 安装代理样式和初始主题，在创建任何窗口之前调用
+    void install(QApplication *app, Theme theme);
+    void setTheme(Theme theme);
+    void toggleTheme();
+    Theme theme() const { return _theme; }
+    const ThemeColors &colors() const { return _colors; }
+    // 预先构建的文字调色板，所有会话项共享
+    const QPalette &textPalette(TextRole role) const { return _textPalettes[role]; }
+    // 按控件的themeRole、state属性设置调色板，没有这些属性的控件不受影响
+    void applyRole(QWidget *widget) const;
+
+signals:
+    void sig_theme_changed(Theme theme);
+
+private:
+    ThemeMgr();
+    static ThemeColors colorsFor(Theme theme);
+    QPalette appPalette() const;
+    void rebuildTextPalettes();
+
+    Theme _theme;
+    ThemeColors _colors;
+    QPalette _textPalettes[TEXT_ROLE_COUNT];
+    bool _installed;
+};
+
+#endif // THEMEMGR_H
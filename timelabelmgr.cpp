@@ -0,0 +1,85 @@
+#include "timelabelmgr.h"
+#include <QDateTime>
+
+TimeLabelMgr::TimeLabelMgr() : _yearStartMs(0), _labelCache(2048)
+{
+    recomputeBoundaries();
+    _timer.setSingleShot(true);
+    _timer.setTimerType(Qt::CoarseTimer);
+    connect(&_timer, &QTimer::timeout, this, &TimeLabelMgr::onMinuteTick);
+    scheduleNextTick();
+}
+
+TimeLabelMgr::~TimeLabelMgr()
+{
+}
+
+TimeBucket TimeLabelMgr::bucket(qint64 msecs) const
+{
+    if (msecs >= _dayStartMs[0])
+        return TIME_TODAY;
+    if (msecs >= _dayStartMs[1])
+        return TIME_YESTERDAY;
+    if (msecs >= _dayStartMs[WEEK_DAYS])
+        return TIME_WEEK;
+    if (msecs >= _yearStartMs)
+        return TIME_YEAR;
+    return TIME_OLDER;
+}
+
+QString TimeLabelMgr::label(qint64 msecs)
+{
+    if (QString *cached = _labelCache.object(msecs))
+        return *cached;
+
+    QString text;
+    TimeBucket b = bucket(msecs);
+    if (b == TIME_YESTERDAY) {
+        text = "昨天";
+    } else if (b == TIME_WEEK) {
+        // 找到所在的那一天，直接由今天的日期推出星期
+        static const char *const weekNames[] = {"周一", "周二", "周三", "周四", "周五", "周六", "周日"};
+        int daysAgo = 2;
+        while (daysAgo < WEEK_DAYS && msecs < _dayStartMs[daysAgo])
+            ++daysAgo;
+        text = weekNames[_today.addDays(-daysAgo).dayOfWeek() - 1];
+    } else {
+        QDateTime time = QDateTime::fromMSecsSinceEpoch(msecs);
+        if (b == TIME_TODAY)
+            text = time.toString("HH:mm");
+        else if (b == TIME_YEAR)
+            text = time.toString("MM-dd");
+        else
+            text = time.toString("yyyy-MM-dd");
+    }
+    _labelCache.insert(msecs, new QString(text));
+    return text;
+}
+
+// 整分钟检查一次日期，没有跨天什么也不做
+void TimeLabelMgr::onMinuteTick()
+{
+    if (QDate::currentDate() != _today) {
+        recomputeBoundaries();
+        emit sig_day_changed();
+    }
+    scheduleNextTick();
+}
+
+void TimeLabelMgr::recomputeBoundaries()
+{
+    _today = QDate::currentDate();
+    for (int i = 0; i <= WEEK_DAYS; ++i) {
+        _dayStartMs[i] = _today.addDays(-i).startOfDay().toMSecsSinceEpoch();
+    }
+    _yearStartMs = QDate(_today.year(), 1, 1).startOfDay().toMSecsSinceEpoch();
+    _labelCache.clear();
+}
+
+// 对齐到下一个整分钟
+void TimeLabelMgr::scheduleNextTick()
+{
+    QTime now = QTime::currentTime();
+    int msecsToNextMinute = 60000 - (now.second() * 1000 + now.msec());
+    _timer.start(msecsToNextMinute + 50);
+}
@@ -0,0 +1,52 @@
+#ifndef TIMELABELMGR_H
+#define TIMELABELMGR_H
+#include <QObject>
+#include <QTimer>
+#include <QDate>
+#include <QCache>
+#include "singleton.h"
+
+// 会话时间标签的分段，分段变化时标签文本才会变化
+enum TimeBucket {
+    TIME_TODAY,      // 今天：HH:mm
+    TIME_YESTERDAY,  // 昨天
+    TIME_WEEK,       // 一周内：周几
+    TIME_YEAR,       // 今年：MM-dd
+    TIME_OLDER       // 更早：yyyy-MM-dd
+};
+
+/**
+ * @brief 相对时间标签服务
+ * 每次整分钟计时只检查一次日期，跨天时重新计算各分段的起始时间戳并通知刷新；
+ * 格式化结果按时间戳缓存，跨天时清空。
+ */
+class TimeLabelMgr : public QObject, public Singleton<TimeLabelMgr>,
+                     public std::enable_shared_from_this<TimeLabelMgr>
+{
+    Q_OBJECT
+public:
+    friend class Singleton<TimeLabelMgr>;
+    ~TimeLabelMgr();
+    // 时间戳所在的分段，只做整数比较
+    TimeBucket bucket(qint64 msecs) const;
+    // 格式化后的时间标签
+    QString label(qint64 msecs);
+
+signals:
+    void sig_day_changed(); // 日期变化（午夜或系统时间跳变），各行需要按分段检查标签
+
+private:
+    TimeLabelMgr();
+    void onMinuteTick();
+    void recomputeBoundaries();
+    void scheduleNextTick();
+
+    static const int WEEK_DAYS = 7;
+    QTimer _timer;                      // 全局唯一的整分钟计时器
+    QDate _today;                       // 当前日期
+    qint64 _dayStartMs[WEEK_DAYS + 1];  // 今天及之前7天的零点时间戳
+    qint64 _yearStartMs;                // 今年1月1日零点时间戳
+    QCache<qint64, QString> _labelCache; // 时间戳 -> 标签
+};
+
+#endif // TIMELABELMGR_H
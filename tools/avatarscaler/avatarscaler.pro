@@ -0,0 +1,10 @@
+QT       = core gui
+
+CONFIG += c++17 console
+CONFIG -= app_bundle
+
+TARGET = avatarscaler
+DESTDIR = ./bin
+
+SOURCES += \
+    main.cpp
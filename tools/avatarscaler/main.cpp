@@ -0,0 +1,91 @@
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QImage>
+#include <QTextStream>
+#include <QDebug>
+
+// 居中裁成正方形再缩放到目标边长
+static QImage scaleSquare(const QImage &source, int side)
+{
+    const int edge = qMin(source.width(), source.height());
+    const QImage square = source.copy((source.width() - edge) / 2, (source.height() - edge) / 2, edge, edge);
+    return square.scaled(side, side, Qt::IgnoreAspectRatio, Qt::SmoothTransformation);
+}
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication a(argc, argv); // 只做图片编解码，不需要平台插件
+    QCoreApplication::setApplicationName("avatarscaler");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("把内置头像缩放到实际显示尺寸，并生成带别名的qrc");
+    parser.addHelpOption();
+    QCommandLineOption outOption("out", "输出目录", "dir");
+    QCommandLineOption sizeOption("size", "显示边长（逻辑像素）", "px", "40");
+    QCommandLineOption scalesOption("scales", "设备像素比，逗号分隔", "list", "1,2");
+    QCommandLineOption prefixOption("prefix", "qrc前缀", "prefix", "/LogReg");
+    parser.addOptions({outOption, sizeOption, scalesOption, prefixOption});
+    parser.addPositionalArgument("images", "源图片");
+    parser.process(a);
+
+    const QStringList inputs = parser.positionalArguments();
+    const QString outDir = parser.value(outOption);
+    const int size = parser.value(sizeOption).toInt();
+    if (inputs.isEmpty() || outDir.isEmpty() || size <= 0) {
+        parser.showHelp(1);
+    }
+    QList<int> scales;
+    for (const QString &scale : parser.value(scalesOption).split(',', Qt::SkipEmptyParts)) {
+        if (scale.toInt() > 0)
+            scales.append(scale.toInt());
+    }
+    if (!QDir().mkpath(outDir)) {
+        qCritical() << "无法创建输出目录:" << outDir;
+        return 1;
+    }
+
+    // 别名统一为avatars/<名字>.png，与源文件的扩展名无关（原先avatar2是jpg，代码里却按png引用）
+    QString qrc;
+    QTextStream qrcStream(&qrc);
+    qrcStream << "<RCC>\n    <qresource prefix=\"" << parser.value(prefixOption) << "\">\n";
+
+    qint64 inputBytes = 0;
+    qint64 outputBytes = 0;
+    for (const QString &input : inputs) {
+        QImage source(input);
+        if (source.isNull()) {
+            qCritical() << "无法读取图片:" << input;
+            return 1;
+        }
+        inputBytes += QFileInfo(input).size();
+        const QString name = QFileInfo(input).completeBaseName();
+        for (int scale : std::as_const(scales)) {
+            const QString suffix = scale == 1 ? QString() : QString("@%1x").arg(scale);
+            const QString fileName = name + suffix + ".png";
+            const QString outPath = QDir(outDir).filePath(fileName);
+            if (!scaleSquare(source, size * scale).save(outPath, "PNG")) {
+                qCritical() << "写入失败:" << outPath;
+                return 1;
+            }
+            outputBytes += QFileInfo(outPath).size();
+            qrcStream << "        <file alias=\"avatars/" << fileName << "\">" << fileName << "</file>\n";
+        }
+    }
+    qrcStream << "    </qresource>\n</RCC>\n";
+
+    QFile qrcFile(QDir(outDir).filePath("avatars.qrc"));
+    if (!qrcFile.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        qCritical() << "无法写入:" << qrcFile.fileName();
+        return 1;
+    }
+    qrcFile.write(qrc.toUtf8());
+
+    qInfo().noquote() << QString("缩放 %1 张头像到 %2px x%3: %4 KB -> %5 KB")
+                             .arg(inputs.size()).arg(size)
+                             .arg(parser.value(scalesOption))
+                             .arg(inputBytes / 1024).arg(outputBytes / 1024);
+    return 0;
+}
@@ -0,0 +1,41 @@
+#!/usr/bin/env bash
+# 端到端压测：在本机启动替身服务器（网关+聊天），offscreen平台下客户端自动登录，
+# 输出登录到进入聊天各阶段的耗时，以及推送消息的入站速率和延迟
+# 用法: tools/e2e_bench.sh <BaijiuChat可执行文件> <fakeserver可执行文件> [运行秒数，默认20] [fakeserver的其他参数...]
+# 例: tools/e2e_bench.sh ./BaijiuChat ./fakeserver 30 --message-rate 2000 --latency 30 --jitter 10 --loss 1
+# 设置OUTBOX_BENCH=outboxbench可执行文件（tests/outboxbench）时，客户端跑完后再用它压测发件箱的发送吞吐和fsync批量，
+# 条数由OUTBOX_COUNT指定（默认100000）；改了fakeserver的--chat-port时用OUTBOX_ARGS="--port ..."传给它
+# 网关端口需与客户端config.ini一致（默认8080）
+set -euo pipefail
+
+APP=${1:?"用法: $0 <BaijiuChat可执行文件> <fakeserver可执行文件> [秒数] [fakeserver参数...]"}
+SERVER=${2:?"用法: $0 <BaijiuChat可执行文件> <fakeserver可执行文件> [秒数] [fakeserver参数...]"}
+SECONDS_TO_RUN=${3:-20}
+shift $(( $# < 3 ? $# : 3 ))
+
+WORK_DIR=$(mktemp -d)
+trap 'kill "$SERVER_PID" 2>/dev/null || true; rm -rf "$WORK_DIR"' EXIT
+
+"$SERVER" "$@" > "$WORK_DIR/server.log" 2>&1 &
+SERVER_PID=$!
+sleep 1
+
+# 本地数据库放到临时目录，每次都从空库开始全量同步
+XDG_DATA_HOME="$WORK_DIR/data" \
+QT_QPA_PLATFORM=offscreen \
+BAIJIU_AUTO_LOGIN="bench@example.com:Bench1234" \
+    timeout "$SECONDS_TO_RUN" "$APP" > "$WORK_DIR/client.log" 2>&1 || true
+
+if [ -n "${OUTBOX_BENCH:-}" ]; then
+    # shellcheck disable=SC2086
+    "$OUTBOX_BENCH" --count "${OUTBOX_COUNT:-100000}" ${OUTBOX_ARGS:-} > "$WORK_DIR/outbox.log" 2>&1 || true
+fi
+
+echo "== 登录到进入聊天 =="
+grep -E "网关登录响应|聊天服务器已连接|聊天登录完成|登录到会话列表首帧|登录到会话同步完成" "$WORK_DIR/client.log" || true
+echo "== 入站消息 =="
+grep "入站消息" "$WORK_DIR/client.log" | tail -n 5 || true
+echo "== 发件箱 =="
+grep -h "发件箱" "$WORK_DIR/client.log" "$WORK_DIR/outbox.log" 2>/dev/null | tail -n 5 || true
+echo "== 服务器 =="
+grep -E "推送|收到客户端消息|链路劣化|模拟重传" "$WORK_DIR/server.log" | tail -n 5 || true
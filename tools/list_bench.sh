@@ -0,0 +1,21 @@
+#!/usr/bin/env bash
+# 会话列表压测：offscreen平台下生成固定种子的1k/10k/100k/1M行数据，测量加载、排序、增改、滚动和内存
+# 压测目标在tests/chatlistbench（qmake tests/tests.pro && make），结果按提交号写成JSON，两次提交的结果可以直接diff
+# 用法: tools/list_bench.sh <tst_chatlistbench可执行文件> [输出目录，默认bench_results] [规模列表，默认1000,10000,100000,1000000]
+set -euo pipefail
+
+BENCH=${1:?"用法: $0 <tst_chatlistbench可执行文件> [输出目录] [规模列表]"}
+OUT_DIR=${2:-bench_results}
+SIZES=${3:-1000,10000,100000,1000000}
+
+LABEL=$(git rev-parse --short HEAD 2>/dev/null || date +%Y%m%d%H%M%S)
+mkdir -p "$OUT_DIR"
+XML="$OUT_DIR/list_bench_$LABEL.xml"
+OUT="$OUT_DIR/list_bench_$LABEL.json"
+
+QT_QPA_PLATFORM=offscreen \
+BAIJIU_LIST_BENCH_SIZES="$SIZES" \
+    "$BENCH" -o "$XML,xml" -o "-,txt"
+
+python3 "$(dirname "$0")/qtest_json.py" --label "$LABEL" "$XML" > "$OUT"
+echo "结果: $OUT"
@@ -0,0 +1,43 @@
+#!/usr/bin/env python3
+# 把QtTest的XML输出（-o 文件,xml）里的压测结果转成JSON，方便不同提交之间直接diff
+# 用法: tools/qtest_json.py <xml文件> [--label 标签] > 结果.json
+import argparse
+import json
+import sys
+import xml.etree.ElementTree as ET
+
+
+def main():
+    parser = argparse.ArgumentParser()
+    parser.add_argument("xml")
+    parser.add_argument("--label", default="")  # 一般填提交号
+    args = parser.parse_args()
+
+    root = ET.parse(args.xml).getroot()
+    env = root.find("Environment")
+    results = []
+    for function in root.iter("TestFunction"):
+        for bench in function.iter("BenchmarkResult"):
+            results.append({
+                "function": function.get("name"),
+                "tag": bench.get("tag"),
+                "metric": bench.get("metric"),
+                "value": float(bench.get("value")),
+                "iterations": int(bench.get("iterations")),
+            })
+    failed = [f.get("name") for f in root.iter("TestFunction")
+              if any(i.get("type") in ("fail", "xpass") for i in f.iter("Incident"))]
+
+    json.dump({
+        "label": args.label,
+        "test": root.get("name"),
+        "qt": env.findtext("QtVersion") if env is not None else None,
+        "results": results,
+        "failed": failed,
+    }, sys.stdout, ensure_ascii=False, indent=2)
+    sys.stdout.write("\n")
+    return 1 if failed else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
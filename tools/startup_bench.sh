@@ -0,0 +1,69 @@
+#!/usr/bin/env bash
+# 启动压测：以offscreen平台反复启动客户端，首帧绘制后自动退出，统计冷/热启动的p50和p95
+# 同时输出可执行文件大小和缺页次数，用于比较头像内嵌与外置avatars.rcc两种打包方式
+# 用法: tools/startup_bench.sh <BaijiuChat可执行文件> [次数，默认20]
+# 冷启动需要清空页缓存（root权限），没有权限时只把第一次运行算作冷启动
+set -euo pipefail
+
+APP=${1:?"用法: $0 <BaijiuChat可执行文件> [次数]"}
+RUNS=${2:-20}
+
+export QT_QPA_PLATFORM=offscreen
+export BAIJIU_EXIT_AFTER_FIRST_FRAME=1
+
+# 运行一次，输出首帧耗时（毫秒）
+run_once() {
+    "$APP" 2>&1 | sed -n 's/.*startup_first_frame_ms \([0-9]\+\).*/\1/p' | head -n 1
+}
+
+drop_caches() {
+    if [ -w /proc/sys/vm/drop_caches ]; then
+        sync
+        echo 3 > /proc/sys/vm/drop_caches
+        return 0
+    fi
+    return 1
+}
+
+# 从标准输入读入耗时，输出p50/p95
+percentiles() {
+    sort -n | awk '{ v[NR] = $1 }
+        END {
+            if (NR == 0) { print "无数据"; exit }
+            p50 = v[int((NR - 1) * 0.50) + 1]
+            p95 = v[int((NR - 1) * 0.95) + 1]
+            printf "p50=%sms p95=%sms (n=%d)\n", p50, p95, NR
+        }'
+}
+
+cold=()
+if drop_caches; then
+    for ((i = 0; i < RUNS; i++)); do
+        drop_caches
+        cold+=("$(run_once)")
+    done
+else
+    echo "无法清空页缓存（需要root），冷启动只统计首次运行" >&2
+    cold+=("$(run_once)")
+fi
+
+warm=()
+for ((i = 0; i < RUNS; i++)); do
+    warm+=("$(run_once)")
+done
+
+echo "冷启动: $(printf '%s\n' "${cold[@]}" | grep . | percentiles)"
+echo "热启动: $(printf '%s\n' "${warm[@]}" | grep . | percentiles)"
+
+# 可执行文件和外置头像资源的大小，以及一次热启动的缺页次数
+size_of() {
+    stat -c %s "$1" 2>/dev/null || wc -c < "$1"
+}
+echo "可执行文件: $(size_of "$APP") 字节"
+RCC="$(dirname "$APP")/avatars.rcc"
+if [ -f "$RCC" ]; then
+    echo "avatars.rcc: $(size_of "$RCC") 字节"
+fi
+if [ -x /usr/bin/time ]; then
+    /usr/bin/time -f "缺页: major=%F minor=%R" "$APP" 2>&1 >/dev/null | grep '缺页' || true
+fi
@@ -0,0 +1,18 @@
+#!/usr/bin/env bash
+# 样式压测：offscreen平台下对比代理样式和旧的全局QSS的控件构造、polish耗时
+# 压测目标在tests/stylebench（qmake tests/tests.pro && make），结果按提交号写成JSON
+# 用法: tools/style_bench.sh <tst_stylebench可执行文件> [输出目录，默认bench_results]
+set -euo pipefail
+
+BENCH=${1:?"用法: $0 <tst_stylebench可执行文件> [输出目录]"}
+OUT_DIR=${2:-bench_results}
+
+LABEL=$(git rev-parse --short HEAD 2>/dev/null || date +%Y%m%d%H%M%S)
+mkdir -p "$OUT_DIR"
+XML="$OUT_DIR/style_bench_$LABEL.xml"
+OUT="$OUT_DIR/style_bench_$LABEL.json"
+
+QT_QPA_PLATFORM=offscreen "$BENCH" -o "$XML,xml" -o "-,txt"
+
+python3 "$(dirname "$0")/qtest_json.py" --label "$LABEL" "$XML" > "$OUT"
+echo "结果: $OUT"
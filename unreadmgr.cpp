@@ -0,0 +1,28 @@
+#include "unreadmgr.h"
+
+UnreadMgr::UnreadMgr()
+{
+    _publishTimer.setSingleShot(true);
+    _publishTimer.setInterval(PUBLISH_INTERVAL);
+    connect(&_publishTimer, &QTimer::timeout, this, &UnreadMgr::publish);
+}
+
+UnreadMgr::~UnreadMgr()
+{
+}
+
+void UnreadMgr::setTotals(const UnreadTotals &totals)
+{
+    _latest = totals;
+    if (_latest != _published && !_publishTimer.isActive())
+        _publishTimer.start();
+}
+
+void UnreadMgr::publish()
+{
+    // 一帧内变化后又回到原值时不必通知
+    if (_latest == _published)
+        return;
+    _published = _latest;
+    emit sig_unread_changed(_published);
+}
@@ -0,0 +1,38 @@
+#ifndef UNREADMGR_H
+#define UNREADMGR_H
+#include <QObject>
+#include <QTimer>
+#include "singleton.h"
+#include "chatitemdata.h"
+
+/**
+ * @brief 未读数汇总服务
+ * 汇总由会话存储增量维护，这里只负责合并发布：一帧内的多次变化只通知一次角标和窗口标题
+ */
+class UnreadMgr : public QObject, public Singleton<UnreadMgr>,
+                  public std::enable_shared_from_this<UnreadMgr>
+{
+    Q_OBJECT
+public:
+    friend class Singleton<UnreadMgr>;
+    ~UnreadMgr();
+    // 提交最新汇总，有变化时安排到下一帧发布
+    void setTotals(const UnreadTotals &totals);
+    // 最近一次发布的汇总
+    const UnreadTotals &totals() const { return _published; }
+
+signals:
+    void sig_unread_changed(const UnreadTotals &totals);
+
+private:
+    UnreadMgr();
+    void publish();
+
+    UnreadTotals _latest;       // 最新提交的汇总
+    UnreadTotals _published;    // 已发布的汇总
+    QTimer _publishTimer;       // 帧合并定时器
+
+    static const int PUBLISH_INTERVAL = 16; // 发布间隔（一帧）
+};
+
+#endif // UNREADMGR_H
@@ -20,7 +20,7 @@ void UserMgr::SetToken(QString token)
     _token = token;
 }
 
-UserMgr::UserMgr()
+UserMgr::UserMgr() : _uid(0)
 {
 
 }
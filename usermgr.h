@@ -14,6 +14,7 @@ public:
     void SetName(QString name);
     void SetUid(int uid);
     void SetToken(QString token);
+    int GetUid() const { return _uid; }
 private:
     UserMgr();
     QString _name;